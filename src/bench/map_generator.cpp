@@ -0,0 +1,380 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <framework/path_builder.h>
+
+/*
+ * Writes the maps and scenarios the README benchmarks run on.
+ * 
+ * Maps are MovingAI .map files and come out the same on every platform for 
+ * the same arguments, since only the raw output of std::mt19937 is used.  
+ * The .scen file next to the map holds random queries between free cells 
+ * of the largest 4-connected region, so every query has a path with either 
+ * movement.  With "any" the queries join any free cells instead, and those 
+ * without a path get a length of 0.  Its optimal lengths are those of 
+ * 8-connected A* here, where diagonal moves may cut corners.
+ * 
+ * usage: a_star_maps random|blocks|rooms|maze size density seed queries file.map [any]
+ * 
+ *   random  density percent of the cells blocked at random
+ *   blocks  density 16 x 16 blocks scattered at random
+ *   rooms   16 x 16 rooms joined by doors, density percent extra doors for loops
+ *   maze    corridors 3 cells wide, density percent extra openings
+ */
+
+namespace
+{
+    struct world
+    {
+        int size;
+        std::vector<char> blocked;
+        
+        explicit world(int _size, bool _blocked) : 
+              size(_size)
+            , blocked(static_cast<std::size_t>(_size) * _size, _blocked ? 1 : 0)
+        {}
+        
+        inline char& at(int _x, int _y) { return blocked[static_cast<std::size_t>(_y) * size + _x]; }
+        
+        void fill(int _x, int _y, int _width, int _height, bool _blocked)
+        {
+            for (int y = _y; y < _y + _height; ++y)
+                for (int x = _x; x < _x + _width; ++x)
+                    at(x, y) = (_blocked ? 1 : 0);
+        }
+    };
+    
+    // Index below _count from the raw generator output, which unlike the 
+    // standard distributions is the same for every library
+    inline int below(std::mt19937& _random, int _count)
+    {
+        return static_cast<int>(_random() % static_cast<uint32_t>(_count));
+    }
+    
+    void random_cells(world& _world, int _percent, std::mt19937& _random)
+    {
+        for (char& cell : _world.blocked)
+            cell = (below(_random, 100) < _percent ? 1 : 0);
+    }
+    
+    void scatter_blocks(world& _world, int _count, std::mt19937& _random)
+    {
+        const int span = std::max(1, _world.size - 15);
+        
+        for (int i = 0; i < _count; ++i)
+        {
+            const int x = below(_random, span);
+            const int y = below(_random, span);
+            _world.fill(x, y, std::min(16, _world.size - x), std::min(16, _world.size - y), true);
+        }
+    }
+    
+    // Spanning tree of _rooms x _rooms cells by depth-first search, then the 
+    // walls left between neighbors opened with _percent chance.  _open is 
+    // called with a cell and the direction, 0 right or 1 up, to open.
+    template<class opener>
+    void join_cells(int _rooms, int _percent, std::mt19937& _random, opener _open)
+    {
+        std::vector<char> visited(static_cast<std::size_t>(_rooms) * _rooms, 0);
+        std::vector<char> opened(static_cast<std::size_t>(_rooms) * _rooms * 2, 0);
+        std::vector<std::pair<int, int>> stack = { { 0, 0 } };
+        visited[0] = 1;
+        
+        const int step_x[4] = { 1, -1, 0, 0 };
+        const int step_y[4] = { 0, 0, 1, -1 };
+        
+        while (!stack.empty())
+        {
+            const int x = stack.back().first;
+            const int y = stack.back().second;
+            int choices[4];
+            int count = 0;
+            
+            for (int i = 0; i < 4; ++i)
+            {
+                const int nx = x + step_x[i];
+                const int ny = y + step_y[i];
+                
+                if (nx >= 0 && ny >= 0 && nx < _rooms && ny < _rooms && !visited[ny * _rooms + nx])
+                    choices[count++] = i;
+            }
+            
+            if (count == 0)
+            {
+                stack.pop_back();
+                continue;
+            }
+            
+            const int i = choices[below(_random, count)];
+            const int nx = x + step_x[i];
+            const int ny = y + step_y[i];
+            
+            // The wall belongs to the lower of the two cells
+            const int wall_x = std::min(x, nx);
+            const int wall_y = std::min(y, ny);
+            const int direction = (step_x[i] != 0 ? 0 : 1);
+            
+            opened[(static_cast<std::size_t>(wall_y) * _rooms + wall_x) * 2 + direction] = 1;
+            _open(wall_x, wall_y, direction);
+            
+            visited[ny * _rooms + nx] = 1;
+            stack.push_back({ nx, ny });
+        }
+        
+        for (int y = 0; y < _rooms; ++y)
+        {
+            for (int x = 0; x < _rooms; ++x)
+            {
+                for (int direction = 0; direction < 2; ++direction)
+                {
+                    if ((direction == 0 ? x + 1 : y + 1) >= _rooms)
+                        continue;
+                    
+                    if (!opened[(static_cast<std::size_t>(y) * _rooms + x) * 2 + direction] 
+                        && below(_random, 100) < _percent)
+                        _open(x, y, direction);
+                }
+            }
+        }
+    }
+    
+    // Walls every 16 cells with doors 3 cells wide at random along them
+    void build_rooms(world& _world, int _percent, std::mt19937& _random)
+    {
+        for (int y = 0; y < _world.size; ++y)
+            for (int x = 0; x < _world.size; ++x)
+                _world.at(x, y) = (x % 16 == 0 || y % 16 == 0 ? 1 : 0);
+        
+        join_cells(_world.size / 16, _percent, _random, [&](int _x, int _y, int _direction)
+        {
+            const int door = 1 + below(_random, 13);
+            
+            if (_direction == 0)
+                _world.fill(_x * 16 + 16, _y * 16 + door, 1, 3, false);
+            else
+                _world.fill(_x * 16 + door, _y * 16 + 16, 3, 1, false);
+        });
+    }
+    
+    // Cells 3 wide on a pitch of 4, carved out of a blocked world
+    void build_maze(world& _world, int _percent, std::mt19937& _random)
+    {
+        const int cells = _world.size / 4;
+        
+        for (int y = 0; y < cells; ++y)
+            for (int x = 0; x < cells; ++x)
+                _world.fill(x * 4 + 1, y * 4 + 1, 3, 3, false);
+        
+        join_cells(cells, _percent, _random, [&](int _x, int _y, int _direction)
+        {
+            if (_direction == 0)
+                _world.fill(_x * 4 + 4, _y * 4 + 1, 1, 3, false);
+            else
+                _world.fill(_x * 4 + 1, _y * 4 + 4, 3, 1, false);
+        });
+    }
+    
+    // Free cells of the largest 4-connected region
+    std::vector<int> largest_region(world& _world)
+    {
+        std::vector<int> labels(_world.blocked.size(), -1);
+        std::vector<int> best;
+        std::vector<int> region;
+        
+        for (std::size_t seed = 0; seed < _world.blocked.size(); ++seed)
+        {
+            if (_world.blocked[seed] || labels[seed] >= 0)
+                continue;
+            
+            region.assign(1, static_cast<int>(seed));
+            labels[seed] = static_cast<int>(seed);
+            
+            for (std::size_t next = 0; next < region.size(); ++next)
+            {
+                const int x = region[next] % _world.size;
+                const int y = region[next] / _world.size;
+                const int neighbors[4][2] = { { x + 1, y }, { x - 1, y }, { x, y + 1 }, { x, y - 1 } };
+                
+                for (const auto& neighbor : neighbors)
+                {
+                    if (neighbor[0] < 0 || neighbor[1] < 0 || neighbor[0] >= _world.size || neighbor[1] >= _world.size)
+                        continue;
+                    
+                    const int id = neighbor[1] * _world.size + neighbor[0];
+                    
+                    if (!_world.blocked[id] && labels[id] < 0)
+                    {
+                        labels[id] = static_cast<int>(seed);
+                        region.push_back(id);
+                    }
+                }
+            }
+            
+            if (region.size() > best.size())
+                best.swap(region);
+        }
+        
+        return best;
+    }
+    
+    bool write_map(const std::string& _path, world& _world)
+    {
+        std::FILE* file = std::fopen(_path.c_str(), "w");
+        
+        if (!file)
+            return false;
+        
+        std::fprintf(file, "type octile\nheight %d\nwidth %d\nmap\n", _world.size, _world.size);
+        std::vector<char> row(static_cast<std::size_t>(_world.size) + 1, '\n');
+        
+        for (int y = 0; y < _world.size; ++y)
+        {
+            for (int x = 0; x < _world.size; ++x)
+                row[x] = (_world.at(x, y) ? '@' : '.');
+            
+            std::fwrite(row.data(), 1, row.size(), file);
+        }
+        
+        return (std::fclose(file) == 0);
+    }
+    
+    double path_length(const vector2_array_i& _path)
+    {
+        double length = 0.0;
+        
+        for (std::size_t i = 1; i < _path.size(); ++i)
+            length += (_path[i].x != _path[i - 1].x && _path[i].y != _path[i - 1].y ? std::sqrt(2.0) : 1.0);
+        
+        return length;
+    }
+    
+    std::vector<int> free_cells(world& _world)
+    {
+        std::vector<int> cells;
+        
+        for (int i = 0; i < _world.size * _world.size; ++i)
+            if (!_world.blocked[i])
+                cells.push_back(i);
+        
+        return cells;
+    }
+    
+    bool write_scenarios(const std::string& _map_path, world& _world, int _queries, bool _any, std::mt19937& _random)
+    {
+        const std::vector<int> region = (_any ? free_cells(_world) : largest_region(_world));
+        
+        if (region.size() < 2)
+            return false;
+        
+        path_builder builder;
+        
+        if (!builder.load_map(_map_path))
+            return false;
+        
+        builder.set_search_backend(search_backend::CELL_ARRAYS);
+        builder.set_diagonal_movement(true);
+        builder.set_heuristic(path_builder::octagonal);
+        
+        std::FILE* file = std::fopen((_map_path + ".scen").c_str(), "w");
+        
+        if (!file)
+            return false;
+        
+        const std::size_t slash = _map_path.find_last_of('/');
+        const std::string map_name = (slash == std::string::npos ? _map_path : _map_path.substr(slash + 1));
+        
+        std::fprintf(file, "version 1\n");
+        
+        for (int i = 0; i < _queries; ++i)
+        {
+            const int start = region[below(_random, static_cast<int>(region.size()))];
+            const int goal = region[below(_random, static_cast<int>(region.size()))];
+            
+            path_data query;
+            query.start_coordinate = { start % _world.size, start / _world.size };
+            query.end_coordinate = { goal % _world.size, goal / _world.size };
+            
+            // The reachability check leaves queries without a path empty
+            const double length = path_length(builder.find_path(query));
+            
+            std::fprintf(file, "%d\t%s\t%d\t%d\t%d\t%d\t%d\t%d\t%.8f\n", 
+                static_cast<int>(length / 4), map_name.c_str(), _world.size, _world.size, 
+                query.start_coordinate.x, query.start_coordinate.y, 
+                query.end_coordinate.x, query.end_coordinate.y, length);
+        }
+        
+        return (std::fclose(file) == 0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::string kind = (argc == 7 || argc == 8 ? argv[1] : "");
+    const bool any = (argc == 8 && std::string(argv[7]) == "any");
+    
+    if ((kind != "random" && kind != "blocks" && kind != "rooms" && kind != "maze") || (argc == 8 && !any))
+    {
+        std::fprintf(stderr, "usage: %s random|blocks|rooms|maze size density seed queries file.map [any]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    const int size = std::atoi(argv[2]);
+    const int density = std::atoi(argv[3]);
+    const int queries = std::atoi(argv[5]);
+    const std::string path = argv[6];
+    
+    if (size < 17 || size > 8192 || density < 0 || queries < 0)
+    {
+        std::fprintf(stderr, "size must be 17 to 8192, density and queries at least 0\n");
+        return EXIT_FAILURE;
+    }
+    
+    std::mt19937 random(static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)));
+    world generated(size, kind == "maze");
+    
+    if (kind == "random")
+        random_cells(generated, density, random);
+    else if (kind == "blocks")
+        scatter_blocks(generated, density, random);
+    else if (kind == "rooms")
+        build_rooms(generated, density, random);
+    else
+        build_maze(generated, density, random);
+    
+    if (!write_map(path, generated) || !write_scenarios(path, generated, queries, any, random))
+    {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,982 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <framework/moving_ai_loader.h>
+#include <framework/path_builder.h>
+#include <parallel/thread_pool.h>
+
+/*
+ * Runs path_builder over MovingAI scenario files and prints JSON.
+ * 
+ * Every scenario file is run on its map for each search mode, heuristic, 
+ * movement, open list, thread count and tile budget asked for, with one run 
+ * object per combination.  Thread counts above 0 solve all queries in one 
+ * find_paths batch, which has no latency per query.  Tile budgets above 0 
+ * copy the map into a tile file and search it through open_world.  A run 
+ * reports queries and expansions per second, latency percentiles, peak 
+ * resident memory, the cost of its paths over the costs A* finds with an 
+ * exact heuristic and the bound path_builder reports on that ratio, which 
+ * batches leave at 0.  The first query of a run is repeated untimed first, 
+ * so that what path_builder builds lazily is reported as the warm-up.  
+ * map_load_ms and scenario_load_ms are the load_map and read_scenario_file 
+ * calls of the files of the run, made once per scenario file.
+ * 
+ * With --replan each query is planned untimed, then collisions are added 
+ * at that many random free cells and the replan of the same query is what 
+ * gets timed.  The cells are removed before the next query.  Replans have 
+ * no cost ratio, since the optimal costs are those of the unchanged map.
+ * 
+ * With --same-goal every query of a scenario file heads to the goal of its 
+ * first query, as agents sharing a flow field would.
+ * 
+ * With --landmarks every run searches with the ALT heuristic of that many 
+ * landmarks, built over the heuristic asked for, and its build time counts 
+ * in build_ms.
+ * 
+ * --cache sets the capacity of the path cache and --repeat runs the queries 
+ * of each scenario file that many times in a row, which the cache counters 
+ * of each run show.  --no-reachability-check lets queries without a path 
+ * search until they run out of cells.  --pull-string passes every path 
+ * through pull_string inside the timed call, and points reports the mean 
+ * number of coordinates of the paths found.
+ * 
+ * --suboptimality sets the epsilon of the weighted and focal modes, whose 
+ * paths cost at most 1 + epsilon times the optimal cost.  --node-limit sets 
+ * the cells the memory-bounded mode remembers.
+ * 
+ * usage: a_star_bench [--modes astar,fringe] [--heuristics octagonal] 
+ *        [--connectivity 4,8] [--backend nodes|cells] 
+ *        [--open-lists binary_heap,bucket_queue] [--threads 0,1,2] 
+ *        [--tiles 0,16,256] [--limit queries] [--hierarchical-guarantee] 
+ *        [--replan cells] [--time-budget ms] [--same-goal] [--landmarks count] 
+ *        [--cache paths] [--repeat times] [--no-reachability-check] 
+ *        [--pull-string] [--suboptimality epsilon] [--node-limit cells] 
+ *        [--maps directory] file.scen...
+ */
+
+namespace
+{
+    typedef std::chrono::steady_clock bench_clock;
+    
+    const char* const tile_file = "a_star_bench.tiles";
+    
+    struct mode_name
+    {
+        const char* name;
+        search_mode mode;
+    };
+    
+    const mode_name modes[] =
+    {
+        { "astar", search_mode::ASTAR },
+        { "jump_point", search_mode::JUMP_POINT },
+        { "hierarchical", search_mode::HIERARCHICAL },
+        { "bidirectional", search_mode::BIDIRECTIONAL },
+        { "incremental", search_mode::INCREMENTAL },
+        { "anytime", search_mode::ANYTIME },
+        { "flow_field", search_mode::FLOW_FIELD },
+        { "contraction", search_mode::CONTRACTION },
+        { "any_angle", search_mode::ANY_ANGLE },
+        { "lazy_any_angle", search_mode::LAZY_ANY_ANGLE },
+        { "weighted", search_mode::WEIGHTED },
+        { "focal", search_mode::FOCAL },
+        { "memory_bounded", search_mode::MEMORY_BOUNDED },
+        { "fringe", search_mode::FRINGE }
+    };
+    
+    struct heuristic_name
+    {
+        const char* name;
+        int (*function)(vector2_i, vector2_i);
+    };
+    
+    // The built-in heuristics behind functions path_builder does not know, 
+    // so that they run through std::function instead of the search kernel
+    int manhattan_function(vector2_i _a, vector2_i _b)
+    {
+        return path_builder::manhattan(_a, _b);
+    }
+    
+    int octagonal_function(vector2_i _a, vector2_i _b)
+    {
+        return path_builder::octagonal(_a, _b);
+    }
+    
+    int euclidean_function(vector2_i _a, vector2_i _b)
+    {
+        return path_builder::euclidean(_a, _b);
+    }
+    
+    const heuristic_name heuristics[] =
+    {
+        { "manhattan", path_builder::manhattan },
+        { "octagonal", path_builder::octagonal },
+        { "euclidean", path_builder::euclidean },
+        { "manhattan_function", manhattan_function },
+        { "octagonal_function", octagonal_function },
+        { "euclidean_function", euclidean_function }
+    };
+    
+    struct open_list_name
+    {
+        const char* name;
+        open_list_type type;
+    };
+    
+    const open_list_name open_lists[] =
+    {
+        { "linear_scan", open_list_type::LINEAR_SCAN },
+        { "binary_heap", open_list_type::BINARY_HEAP },
+        { "quaternary_heap", open_list_type::QUATERNARY_HEAP },
+        { "bucket_queue", open_list_type::BUCKET_QUEUE }
+    };
+    
+    struct options
+    {
+        std::vector<std::string> modes;
+        std::vector<std::string> heuristics;
+        std::vector<int> connectivity;
+        search_backend backend;
+        std::vector<std::string> open_lists;
+        std::vector<int> threads;       // 0 for one find_path call per query
+        std::vector<int> tiles;         // tile budgets, 0 for the map in memory
+        std::size_t limit;              // queries per scenario file, 0 for all
+        bool hierarchical_guarantee;    // holds HPA* paths to the weighted bound
+        int replan;                     // cells added before the timed replan, 0 for none
+        double time_budget;             // milliseconds per anytime call, 0 for none
+        bool same_goal;                 // every query heads to the goal of the first
+        int landmarks;                  // ALT landmarks, 0 for the heuristic as named
+        int cache;                      // path cache capacity, 0 for none
+        int repeat;                     // passes over the queries of a scenario file
+        bool reachability_check;        // rejects queries between regions before searching
+        bool pull_string;               // keeps only the waypoints a straight line cannot skip
+        double suboptimality;           // epsilon of the weighted and focal modes, below 0 for the default
+        std::size_t node_limit;         // cells of the memory-bounded mode, 0 for the default
+        std::string maps;
+        std::vector<std::string> scenarios;
+        
+        explicit options() : 
+              modes({ "astar" })
+            , heuristics({ "octagonal" })
+            , connectivity({ 4, 8 })
+            , backend(search_backend::CELL_ARRAYS)
+            , open_lists({ "binary_heap" })
+            , threads({ 0 })
+            , tiles({ 0 })
+            , limit(0)
+            , hierarchical_guarantee(false)
+            , replan(0)
+            , time_budget(0.0)
+            , same_goal(false)
+            , landmarks(0)
+            , cache(0)
+            , repeat(1)
+            , reachability_check(true)
+            , pull_string(false)
+            , suboptimality(-1.0)
+            , node_limit(0)
+        {}
+    };
+    
+    std::vector<std::string> split(const char* _list)
+    {
+        std::vector<std::string> items;
+        std::string item;
+        
+        for (const char* c = _list; ; ++c)
+        {
+            if (*c == ',' || *c == '\0')
+            {
+                if (!item.empty())
+                    items.push_back(item);
+                
+                item.clear();
+                
+                if (*c == '\0')
+                    break;
+            }
+            else
+            {
+                item += *c;
+            }
+        }
+        
+        return items;
+    }
+    
+    bool parse_options(int _argc, char** _argv, options& _options)
+    {
+        for (int i = 1; i < _argc; ++i)
+        {
+            const std::string argument = _argv[i];
+            const bool has_value = (i + 1 < _argc);
+            
+            if (argument == "--modes" && has_value)
+                _options.modes = split(_argv[++i]);
+            else if (argument == "--heuristics" && has_value)
+                _options.heuristics = split(_argv[++i]);
+            else if (argument == "--connectivity" && has_value)
+            {
+                _options.connectivity.clear();
+                
+                for (const std::string& item : split(_argv[++i]))
+                    _options.connectivity.push_back(std::atoi(item.c_str()));
+            }
+            else if (argument == "--backend" && has_value)
+            {
+                const std::string backend = _argv[++i];
+                
+                if (backend != "nodes" && backend != "cells")
+                    return false;
+                
+                _options.backend = (backend == "nodes" ? search_backend::NODE_GRAPH : search_backend::CELL_ARRAYS);
+            }
+            else if (argument == "--open-lists" && has_value)
+                _options.open_lists = split(_argv[++i]);
+            else if (argument == "--threads" && has_value)
+            {
+                _options.threads.clear();
+                
+                for (const std::string& item : split(_argv[++i]))
+                    _options.threads.push_back(std::atoi(item.c_str()));
+            }
+            else if (argument == "--tiles" && has_value)
+            {
+                _options.tiles.clear();
+                
+                for (const std::string& item : split(_argv[++i]))
+                    _options.tiles.push_back(std::atoi(item.c_str()));
+            }
+            else if (argument == "--limit" && has_value)
+                _options.limit = static_cast<std::size_t>(std::atol(_argv[++i]));
+            else if (argument == "--replan" && has_value)
+                _options.replan = std::atoi(_argv[++i]);
+            else if (argument == "--time-budget" && has_value)
+                _options.time_budget = std::atof(_argv[++i]);
+            else if (argument == "--hierarchical-guarantee")
+                _options.hierarchical_guarantee = true;
+            else if (argument == "--same-goal")
+                _options.same_goal = true;
+            else if (argument == "--landmarks" && has_value)
+                _options.landmarks = std::atoi(_argv[++i]);
+            else if (argument == "--cache" && has_value)
+                _options.cache = std::atoi(_argv[++i]);
+            else if (argument == "--repeat" && has_value)
+                _options.repeat = std::atoi(_argv[++i]);
+            else if (argument == "--no-reachability-check")
+                _options.reachability_check = false;
+            else if (argument == "--pull-string")
+                _options.pull_string = true;
+            else if (argument == "--suboptimality" && has_value)
+                _options.suboptimality = std::atof(_argv[++i]);
+            else if (argument == "--node-limit" && has_value)
+                _options.node_limit = static_cast<std::size_t>(std::atol(_argv[++i]));
+            else if (argument == "--maps" && has_value)
+                _options.maps = _argv[++i];
+            else if (argument.compare(0, 2, "--") == 0)
+                return false;
+            else
+                _options.scenarios.push_back(argument);
+        }
+        
+        for (int directions : _options.connectivity)
+            if (directions != 4 && directions != 8)
+                return false;
+        
+        for (int threads : _options.threads)
+            if (threads < 0)
+                return false;
+        
+        for (int tiles : _options.tiles)
+            if (tiles < 0)
+                return false;
+        
+        if (_options.replan < 0 || _options.time_budget < 0.0 || _options.landmarks < 0)
+            return false;
+        
+        if (_options.cache < 0 || _options.repeat < 1)
+            return false;
+        
+        return !_options.scenarios.empty();
+    }
+    
+    const mode_name* find_mode(const std::string& _name)
+    {
+        for (const mode_name& item : modes)
+            if (_name == item.name)
+                return &item;
+        
+        return nullptr;
+    }
+    
+    const heuristic_name* find_heuristic(const std::string& _name)
+    {
+        for (const heuristic_name& item : heuristics)
+            if (_name == item.name)
+                return &item;
+        
+        return nullptr;
+    }
+    
+    const open_list_name* find_open_list(const std::string& _name)
+    {
+        for (const open_list_name& item : open_lists)
+            if (_name == item.name)
+                return &item;
+        
+        return nullptr;
+    }
+    
+    std::string directory_of(const std::string& _path)
+    {
+        const std::size_t slash = _path.find_last_of('/');
+        return (slash == std::string::npos ? std::string() : _path.substr(0, slash + 1));
+    }
+    
+    std::string file_name_of(const std::string& _path)
+    {
+        const std::size_t slash = _path.find_last_of('/');
+        return (slash == std::string::npos ? _path : _path.substr(slash + 1));
+    }
+    
+    bool file_exists(const std::string& _path)
+    {
+        return std::ifstream(_path).good();
+    }
+    
+    // Scenario files name their map relative to a benchmark root, so the 
+    // map is looked for in --maps, next to the scenario file, then as named
+    std::string find_map(const std::string& _scenario, const std::string& _map, const std::string& _maps)
+    {
+        std::vector<std::string> candidates;
+        
+        if (!_maps.empty())
+            candidates.push_back(_maps + "/" + file_name_of(_map));
+        
+        candidates.push_back(directory_of(_scenario) + _map);
+        candidates.push_back(directory_of(_scenario) + file_name_of(_map));
+        candidates.push_back(_map);
+        
+        for (const std::string& candidate : candidates)
+            if (file_exists(candidate))
+                return candidate;
+        
+        return std::string();
+    }
+    
+    // Searches the collisions of the map at _map through a tile file with 
+    // _budget tiles in memory, none of them resident yet
+    bool open_tiled_map(path_builder& _builder, const std::string& _map, std::size_t _budget)
+    {
+        occupancy_grid walls;
+        
+        if (!read_map_file(_map, walls) 
+            || !tiled_grid::create(tile_file, walls.get_size()) 
+            || !_builder.open_world(tile_file, _budget))
+            return false;
+        
+        const vector2_i size = walls.get_size();
+        
+        for (int y = 0; y < size.y; ++y)
+            for (int x = 0; x < size.x; ++x)
+                if (walls.is_blocked(x, y))
+                    _builder.add_collision({ x, y });
+        
+        // Reopened, so that the loads counted are those of the queries
+        _builder.close_world();
+        return _builder.open_world(tile_file, _budget);
+    }
+    
+    // Euclidean length in tenths of a cell, for grid and any-angle paths 
+    // alike, so a diagonal step counts 14.14 here where searches count 14
+    double path_cost(const vector2_array_i& _path)
+    {
+        double cost = 0.0;
+        
+        for (std::size_t i = 1; i < _path.size(); ++i)
+        {
+            const double dx = _path[i].x - _path[i - 1].x;
+            const double dy = _path[i].y - _path[i - 1].y;
+            cost += 10.0 * std::sqrt(dx * dx + dy * dy);
+        }
+        
+        return cost;
+    }
+    
+    bool reaches(const vector2_array_i& _path, vector2_i _goal)
+    {
+        return (!_path.empty() && _path.front() == static_cast<vector2_i>(_goal));
+    }
+    
+    // Lowers the peak resident memory to the current one, where Linux allows it
+    void reset_peak_memory()
+    {
+#ifdef __GLIBC__
+        // Otherwise memory freed by earlier runs stays resident
+        malloc_trim(0);
+#endif
+        
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        
+        if (clear_refs)
+            clear_refs << "5";
+    }
+    
+    std::size_t get_peak_memory()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        
+        while (std::getline(status, line))
+            if (line.compare(0, 6, "VmHWM:") == 0)
+                return static_cast<std::size_t>(std::atol(line.c_str() + 6)) * 1024;
+        
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    }
+    
+    // Nearest-rank percentile of sorted latencies
+    double percentile(const std::vector<double>& _sorted, double _fraction)
+    {
+        if (_sorted.empty())
+            return 0.0;
+        
+        const std::size_t rank = static_cast<std::size_t>(std::ceil(_fraction * _sorted.size()));
+        return _sorted[std::min(_sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+    }
+    
+    double elapsed_us(bench_clock::time_point _start)
+    {
+        return std::chrono::duration<double, std::micro>(bench_clock::now() - _start).count();
+    }
+    
+    void print_string(const std::string& _value)
+    {
+        std::putchar('"');
+        
+        for (char c : _value)
+        {
+            if (c == '"' || c == '\\')
+                std::putchar('\\');
+            
+            std::putchar(c);
+        }
+        
+        std::putchar('"');
+    }
+    
+    struct run_result
+    {
+        std::size_t queries;
+        std::size_t solved;
+        std::size_t points;             // coordinates of the paths found
+        std::size_t expansions;
+        double seconds;
+        double build_ms;
+        double warmup_ms;
+        double map_load_ms;             // load_map of the map, once per scenario file
+        double scenario_load_ms;        // read_scenario_file of the scenario file
+        std::vector<double> latencies_us;
+        std::size_t peak_memory;
+        double ratio_sum;
+        double ratio_max;
+        std::size_t ratio_count;
+        double bound_sum;               // of get_suboptimality_bound over the paths found
+        double bound_max;
+        std::size_t tile_loads;
+        std::size_t cache_hits;
+        std::size_t cache_misses;
+        std::size_t cache_evictions;
+        std::size_t cache_invalidations;
+    };
+    
+    run_result run_queries(
+          path_builder& _builder
+        , const std::vector<path_data>& _queries
+        , const std::vector<double>& _optimal
+        , bool _pull_string)
+    {
+        run_result result = {};
+        
+        reset_peak_memory();
+        
+        // The contraction mode searches like A* until its hierarchy is built
+        bench_clock::time_point start = bench_clock::now();
+        
+        if (_builder.get_search_mode() == search_mode::CONTRACTION)
+            _builder.build_contraction_hierarchy();
+        
+        result.build_ms = elapsed_us(start) / 1000.0;
+        
+        start = bench_clock::now();
+        _builder.find_path(_queries.front());
+        result.warmup_ms = elapsed_us(start) / 1000.0;
+        
+        result.latencies_us.reserve(_queries.size());
+        
+        for (std::size_t i = 0; i < _queries.size(); ++i)
+        {
+            start = bench_clock::now();
+            const vector2_array_i path = (_pull_string 
+                ? _builder.pull_string(_builder.find_path(_queries[i])) 
+                : _builder.find_path(_queries[i]));
+            const double latency = elapsed_us(start);
+            
+            result.latencies_us.push_back(latency);
+            result.seconds += latency / 1e6;
+            result.expansions += _builder.get_expansions();
+            
+            if (!reaches(path, _queries[i].end_coordinate))
+                continue;
+            
+            ++result.solved;
+            result.points += path.size();
+            result.bound_sum += _builder.get_suboptimality_bound();
+            result.bound_max = std::max(result.bound_max, _builder.get_suboptimality_bound());
+            
+            if (_optimal[i] > 0.0)
+            {
+                const double ratio = path_cost(path) / _optimal[i];
+                result.ratio_sum += ratio;
+                result.ratio_max = std::max(result.ratio_max, ratio);
+                ++result.ratio_count;
+            }
+        }
+        
+        result.queries = _queries.size();
+        result.peak_memory = get_peak_memory();
+        std::sort(result.latencies_us.begin(), result.latencies_us.end());
+        
+        return result;
+    }
+    
+    // Times the replan of each query after _changes collisions are added at 
+    // random free cells of _walls, away from its ends
+    run_result run_replans(
+          path_builder& _builder
+        , const occupancy_grid& _walls
+        , const std::vector<path_data>& _queries
+        , int _changes)
+    {
+        run_result result = {};
+        std::mt19937 random(1);
+        std::vector<vector2_i> added;
+        const vector2_i size = _walls.get_size();
+        
+        reset_peak_memory();
+        
+        bench_clock::time_point start = bench_clock::now();
+        _builder.find_path(_queries.front());
+        result.warmup_ms = elapsed_us(start) / 1000.0;
+        
+        result.latencies_us.reserve(_queries.size());
+        
+        for (const path_data& query : _queries)
+        {
+            _builder.find_path(query);
+            added.clear();
+            
+            while (added.size() < static_cast<std::size_t>(_changes))
+            {
+                const vector2_i cell = { static_cast<int>(random() % size.x), static_cast<int>(random() % size.y) };
+                
+                if (_walls.is_blocked(cell) 
+                    || cell == static_cast<vector2_i>(query.start_coordinate) 
+                    || cell == static_cast<vector2_i>(query.end_coordinate) 
+                    || std::find(added.begin(), added.end(), cell) != added.end())
+                    continue;
+                
+                _builder.add_collision(cell);
+                added.push_back(cell);
+            }
+            
+            start = bench_clock::now();
+            const vector2_array_i path = _builder.find_path(query);
+            const double latency = elapsed_us(start);
+            
+            result.latencies_us.push_back(latency);
+            result.seconds += latency / 1e6;
+            result.expansions += _builder.get_expansions();
+            
+            if (reaches(path, query.end_coordinate))
+            {
+                ++result.solved;
+                result.points += path.size();
+            }
+            
+            for (vector2_i cell : added)
+                _builder.remove_collision(cell);
+        }
+        
+        result.queries = _queries.size();
+        result.peak_memory = get_peak_memory();
+        std::sort(result.latencies_us.begin(), result.latencies_us.end());
+        
+        return result;
+    }
+    
+    // Solves every query in one find_paths call on _threads tasks, the 
+    // calling thread included
+    run_result run_batch(
+          path_builder& _builder
+        , const std::vector<path_data>& _queries
+        , const std::vector<double>& _optimal
+        , std::size_t _threads)
+    {
+        run_result result = {};
+        std::vector<vector2_array_i> paths(_queries.size());
+        
+        reset_peak_memory();
+        thread_pool pool(_threads - 1);
+        
+        bench_clock::time_point start = bench_clock::now();
+        
+        if (_builder.get_search_mode() == search_mode::CONTRACTION)
+            _builder.build_contraction_hierarchy();
+        
+        result.build_ms = elapsed_us(start) / 1000.0;
+        
+        start = bench_clock::now();
+        _builder.find_paths(_queries.data(), 1, paths.data(), pool, _threads);
+        result.warmup_ms = elapsed_us(start) / 1000.0;
+        
+        start = bench_clock::now();
+        _builder.find_paths(_queries.data(), _queries.size(), paths.data(), pool, _threads);
+        result.seconds = elapsed_us(start) / 1e6;
+        result.expansions = _builder.get_expansions();
+        
+        for (std::size_t i = 0; i < _queries.size(); ++i)
+        {
+            if (!reaches(paths[i], _queries[i].end_coordinate))
+                continue;
+            
+            ++result.solved;
+            result.points += paths[i].size();
+            
+            if (_optimal[i] > 0.0)
+            {
+                const double ratio = path_cost(paths[i]) / _optimal[i];
+                result.ratio_sum += ratio;
+                result.ratio_max = std::max(result.ratio_max, ratio);
+                ++result.ratio_count;
+            }
+        }
+        
+        result.queries = _queries.size();
+        result.peak_memory = get_peak_memory();
+        
+        return result;
+    }
+    
+    void print_run(
+          bool _first
+        , const std::string& _scenario
+        , const std::string& _map
+        , vector2_i _size
+        , const std::string& _mode
+        , const std::string& _heuristic
+        , int _directions
+        , const std::string& _open_list
+        , int _threads
+        , int _tiles
+        , const run_result& _result)
+    {
+        const double seconds = std::max(_result.seconds, 1e-9);
+        
+        std::printf("%s\n    {\n      \"scenario\": ", _first ? "" : ",");
+        print_string(_scenario);
+        std::printf(",\n      \"map\": ");
+        print_string(_map);
+        std::printf(",\n      \"width\": %d,\n      \"height\": %d,\n", _size.x, _size.y);
+        std::printf("      \"mode\": ");
+        print_string(_mode);
+        std::printf(",\n      \"heuristic\": ");
+        print_string(_heuristic);
+        std::printf(",\n      \"connectivity\": %d,\n      \"open_list\": ", _directions);
+        print_string(_open_list);
+        std::printf(",\n      \"threads\": %d,\n", _threads);
+        std::printf("      \"tile_budget\": %d,\n      \"tile_loads\": %zu,\n", _tiles, _result.tile_loads);
+        std::printf("      \"queries\": %zu,\n      \"solved\": %zu,\n", _result.queries, _result.solved);
+        std::printf("      \"points\": %.1f,\n", 
+            _result.solved ? static_cast<double>(_result.points) / _result.solved : 0.0);
+        std::printf("      \"seconds\": %.6f,\n      \"build_ms\": %.3f,\n      \"warmup_ms\": %.3f,\n", 
+            _result.seconds, _result.build_ms, _result.warmup_ms);
+        std::printf("      \"map_load_ms\": %.3f,\n      \"scenario_load_ms\": %.3f,\n", 
+            _result.map_load_ms, _result.scenario_load_ms);
+        std::printf("      \"queries_per_second\": %.1f,\n", _result.queries / seconds);
+        std::printf("      \"expansions_per_second\": %.1f,\n", _result.expansions / seconds);
+        std::printf("      \"expansions_per_query\": %.1f,\n", 
+            _result.queries ? static_cast<double>(_result.expansions) / _result.queries : 0.0);
+        std::printf("      \"latency_us\": { \"mean\": %.2f, \"p50\": %.2f, \"p99\": %.2f, \"p999\": %.2f, \"max\": %.2f },\n", 
+            _result.queries ? _result.seconds * 1e6 / _result.queries : 0.0, 
+            percentile(_result.latencies_us, 0.5), 
+            percentile(_result.latencies_us, 0.99), 
+            percentile(_result.latencies_us, 0.999), 
+            _result.latencies_us.empty() ? 0.0 : _result.latencies_us.back());
+        std::printf("      \"peak_memory_bytes\": %zu,\n", _result.peak_memory);
+        std::printf("      \"cache\": { \"hits\": %zu, \"misses\": %zu, \"evictions\": %zu, \"invalidations\": %zu },\n", 
+            _result.cache_hits, _result.cache_misses, _result.cache_evictions, _result.cache_invalidations);
+        std::printf("      \"optimality_ratio\": { \"mean\": %.6f, \"max\": %.6f },\n", 
+            _result.ratio_count ? _result.ratio_sum / _result.ratio_count : 0.0, 
+            _result.ratio_max);
+        std::printf("      \"suboptimality_bound\": { \"mean\": %.6f, \"max\": %.6f }\n    }", 
+            _result.solved ? _result.bound_sum / _result.solved : 0.0, 
+            _result.bound_max);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    options settings;
+    
+    if (!parse_options(argc, argv, settings))
+    {
+        std::fprintf(stderr, 
+            "usage: %s [--modes astar,fringe] [--heuristics octagonal] [--connectivity 4,8]\n"
+            "       [--backend nodes|cells] [--open-lists binary_heap,bucket_queue]\n"
+            "       [--threads 0,1,2] [--tiles 0,16,256] [--limit queries] [--hierarchical-guarantee]\n"
+            "       [--replan cells] [--time-budget ms] [--same-goal] [--landmarks count]\n"
+            "       [--cache paths] [--repeat times] [--no-reachability-check] [--pull-string]\n"
+            "       [--suboptimality epsilon] [--node-limit cells] [--maps directory] file.scen...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    for (const std::string& name : settings.modes)
+    {
+        if (!find_mode(name))
+        {
+            std::fprintf(stderr, "unknown mode %s\n", name.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    
+    for (const std::string& name : settings.heuristics)
+    {
+        if (!find_heuristic(name))
+        {
+            std::fprintf(stderr, "unknown heuristic %s\n", name.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    
+    for (const std::string& name : settings.open_lists)
+    {
+        if (!find_open_list(name))
+        {
+            std::fprintf(stderr, "unknown open list %s\n", name.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    
+    bool first = true;
+    int status = EXIT_SUCCESS;
+    
+    // Tells apart the builds whose results get compared
+    std::printf("{\n  \"build\": { \"compiler\": ");
+    print_string(__VERSION__);
+    std::printf(", \"date\": ");
+    print_string(__DATE__ " " __TIME__);
+    std::printf(" },\n  \"settings\": { \"replan\": %d, \"time_budget_ms\": %.3f, \"same_goal\": %s, \"landmarks\": %d, \"cache\": %d, \"repeat\": %d, \"reachability_check\": %s, \"pull_string\": %s, \"suboptimality\": %.3f, \"node_limit\": %zu },\n  \"runs\": [", 
+        settings.replan, settings.time_budget, settings.same_goal ? "true" : "false", settings.landmarks, 
+        settings.cache, settings.repeat, settings.reachability_check ? "true" : "false", 
+        settings.pull_string ? "true" : "false", settings.suboptimality, settings.node_limit);
+    
+    for (const std::string& scenario_path : settings.scenarios)
+    {
+        std::vector<scenario> entries;
+        std::string map_name;
+        bench_clock::time_point load_start = bench_clock::now();
+        
+        if (!read_scenario_file(scenario_path, entries, map_name) || entries.empty())
+        {
+            std::fprintf(stderr, "cannot read scenarios from %s\n", scenario_path.c_str());
+            status = EXIT_FAILURE;
+            continue;
+        }
+        
+        const double scenario_load_ms = elapsed_us(load_start) / 1000.0;
+        const std::string map_path = find_map(scenario_path, map_name, settings.maps);
+        std::unique_ptr<path_builder> reference(new path_builder());
+        occupancy_grid walls;
+        
+        load_start = bench_clock::now();
+        const bool loaded = (!map_path.empty() && reference->load_map(map_path));
+        const double map_load_ms = elapsed_us(load_start) / 1000.0;
+        
+        if (!loaded || (settings.replan != 0 && !read_map_file(map_path, walls)))
+        {
+            std::fprintf(stderr, "cannot load map %s of %s\n", map_name.c_str(), scenario_path.c_str());
+            status = EXIT_FAILURE;
+            continue;
+        }
+        
+        if (settings.limit != 0 && entries.size() > settings.limit)
+            entries.resize(settings.limit);
+        
+        std::vector<path_data> queries(entries.size());
+        
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            queries[i].start_coordinate = entries[i].start;
+            queries[i].end_coordinate = (settings.same_goal ? entries.front().goal : entries[i].goal);
+        }
+        
+        // Optimal costs of each movement, from A* with an exact heuristic
+        std::vector<std::vector<double>> optimal(settings.connectivity.size());
+        reference->set_search_backend(search_backend::CELL_ARRAYS);
+        
+        for (std::size_t c = 0; c < settings.connectivity.size(); ++c)
+        {
+            reference->set_diagonal_movement(settings.connectivity[c] == 8);
+            reference->set_heuristic(settings.connectivity[c] == 8 ? path_builder::octagonal : path_builder::manhattan);
+            optimal[c].resize(queries.size());
+            
+            for (std::size_t i = 0; i < queries.size(); ++i)
+            {
+                const vector2_array_i path = reference->find_path(queries[i]);
+                optimal[c][i] = (reaches(path, queries[i].end_coordinate) ? path_cost(path) : 0.0);
+            }
+        }
+        
+        reference.reset();
+        
+        // The optimal costs repeat with their queries
+        const std::vector<path_data> pass_queries = queries;
+        const std::vector<std::vector<double>> pass_optimal = optimal;
+        
+        for (int pass = 1; pass < settings.repeat; ++pass)
+        {
+            queries.insert(queries.end(), pass_queries.begin(), pass_queries.end());
+            
+            for (std::size_t c = 0; c < optimal.size(); ++c)
+                optimal[c].insert(optimal[c].end(), pass_optimal[c].begin(), pass_optimal[c].end());
+        }
+        
+        for (std::size_t c = 0; c < settings.connectivity.size(); ++c)
+        {
+            const int directions = settings.connectivity[c];
+            
+            for (const std::string& heuristic : settings.heuristics)
+            {
+                for (const std::string& mode : settings.modes)
+                {
+                    for (const std::string& open_list : settings.open_lists)
+                    {
+                        for (int threads : settings.threads)
+                        {
+                            for (int tiles : settings.tiles)
+                            {
+                                // A new builder per run, so that memory left by other 
+                                // runs does not count toward its peak
+                                path_builder builder;
+                                
+                                if (tiles == 0)
+                                    builder.load_map(map_path);
+                                else if (!open_tiled_map(builder, map_path, static_cast<std::size_t>(tiles)))
+                                {
+                                    std::fprintf(stderr, "cannot write %s for %s\n", tile_file, map_path.c_str());
+                                    status = EXIT_FAILURE;
+                                    continue;
+                                }
+                                
+                                builder.set_diagonal_movement(directions == 8);
+                                builder.set_heuristic(find_heuristic(heuristic)->function);
+                                builder.set_search_backend(settings.backend);
+                                builder.set_open_list(find_open_list(open_list)->type);
+                                builder.set_search_mode(find_mode(mode)->mode);
+                                builder.set_hierarchical_guarantee(settings.hierarchical_guarantee);
+                                builder.set_time_budget(settings.time_budget);
+                                builder.set_path_cache(static_cast<std::size_t>(settings.cache));
+                                builder.set_reachability_check(settings.reachability_check);
+                                
+                                if (settings.suboptimality >= 0.0)
+                                    builder.set_suboptimality(settings.suboptimality);
+                                
+                                if (settings.node_limit != 0)
+                                    builder.set_node_limit(settings.node_limit);
+                                
+                                double landmark_ms = 0.0;
+                                
+                                if (settings.landmarks != 0)
+                                {
+                                    thread_pool pool(0);
+                                    const bench_clock::time_point start = bench_clock::now();
+                                    
+                                    builder.set_heuristic(builder.build_landmark_heuristic(
+                                        static_cast<std::size_t>(settings.landmarks), pool, 1));
+                                    landmark_ms = elapsed_us(start) / 1000.0;
+                                }
+                                
+                                run_result result = (threads != 0 
+                                    ? run_batch(builder, queries, optimal[c], static_cast<std::size_t>(threads)) 
+                                    : settings.replan != 0 
+                                    ? run_replans(builder, walls, queries, settings.replan) 
+                                    : run_queries(builder, queries, optimal[c], settings.pull_string));
+                                result.tile_loads = builder.get_world_tiles().get_tile_loads();
+                                result.build_ms += landmark_ms;
+                                result.map_load_ms = map_load_ms;
+                                result.scenario_load_ms = scenario_load_ms;
+                                result.cache_hits = builder.get_path_cache().get_hits();
+                                result.cache_misses = builder.get_path_cache().get_misses();
+                                result.cache_evictions = builder.get_path_cache().get_evictions();
+                                result.cache_invalidations = builder.get_path_cache().get_invalidations();
+                                
+                                print_run(first, file_name_of(scenario_path), file_name_of(map_path), 
+                                    builder.get_world_size(), mode, heuristic, directions, open_list, threads, tiles, result);
+                                first = false;
+                                std::fflush(stdout);
+                                
+                                if (tiles != 0)
+                                {
+                                    builder.close_world();
+                                    std::remove(tile_file);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    std::printf("\n  ]\n}\n");
+    
+    return status;
+}
@@ -0,0 +1,224 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "any_angle_search.h"
+#include <algorithm>
+#include <cmath>
+#include <framework/line_of_sight.h>
+#include <framework/search_grid.h>
+
+namespace
+{
+    const double diagonal_step = 1.4142135623730951;
+    
+    inline double distance(int _x0, int _y0, int _x1, int _y1)
+    {
+        const double dx = _x1 - _x0;
+        const double dy = _y1 - _y0;
+        
+        return std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+any_angle_search::any_angle_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , expansions(0)
+    , line_checks(0)
+    , cost(0.0)
+    , generation(0)
+{}
+
+vector2_array_i any_angle_search::find_path(vector2_i _start, vector2_i _goal, bool _diagonal, bool _lazy)
+{
+    expansions = 0;
+    line_checks = 0;
+    cost = 0.0;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    const int width = walls.get_size().x;
+    const std::size_t count = static_cast<std::size_t>(width) * walls.get_size().y;
+    const int directions = (_diagonal ? 8 : 4);
+    
+    if (stamps.size() != count)
+    {
+        g.assign(count, 0.0);
+        parents.assign(count, 0);
+        states.assign(count, UNSEEN);
+        stamps.assign(count, 0);
+        generation = 0;
+    }
+    
+    if (++generation == 0)
+    {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+    
+    open.reset(count);
+    
+    const uint32_t start = static_cast<uint32_t>(_start.y * width + _start.x);
+    const uint32_t goal = static_cast<uint32_t>(_goal.y * width + _goal.x);
+    
+    stamps[start] = generation;
+    states[start] = OPEN;
+    g[start] = 0.0;
+    parents[start] = start;
+    open.push(start, distance(_start.x, _start.y, _goal.x, _goal.y), 0.0);
+    
+    bool found = false;
+    
+    while (!open.empty())
+    {
+        const uint32_t current = open.pop();
+        const int x = static_cast<int>(current % width);
+        const int y = static_cast<int>(current / width);
+        
+        states[current] = CLOSED;
+        
+        // Lazy Theta* verifies the parent it assumed, or takes the best 
+        // expanded neighbor instead
+        if (_lazy && !line_of_sight(parents[current], current, width, _diagonal))
+        {
+            g[current] = HUGE_VAL;
+            
+            for (int i = 0; i < directions; ++i)
+            {
+                const int nx = x + grid_direction_x[i];
+                const int ny = y + grid_direction_y[i];
+                
+                if (walls.is_blocked(nx, ny))
+                    continue;
+                
+                const uint32_t id = static_cast<uint32_t>(ny * width + nx);
+                
+                if (get_state(id) != CLOSED)
+                    continue;
+                
+                const double total_cost = g[id] + (i < 4 ? 1.0 : diagonal_step);
+                
+                if (total_cost < g[current])
+                {
+                    g[current] = total_cost;
+                    parents[current] = id;
+                }
+            }
+            
+            // The assumed parent gave it too low an f, so it waits for its 
+            // turn again, or paths could come out longer than on the grid
+            states[current] = OPEN;
+            open.push(current, g[current] + distance(x, y, _goal.x, _goal.y), g[current]);
+            continue;
+        }
+        
+        if (current == goal)
+        {
+            found = true;
+            break;
+        }
+        
+        ++expansions;
+        
+        const uint32_t parent = parents[current];
+        const int parent_x = static_cast<int>(parent % width);
+        const int parent_y = static_cast<int>(parent / width);
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = static_cast<uint32_t>(ny * width + nx);
+            const uint8_t state = get_state(id);
+            
+            if (state == CLOSED)
+                continue;
+            
+            // Through the parent of the current cell when the line is free, 
+            // through the current cell otherwise
+            uint32_t via = parent;
+            double total_cost = g[parent] + distance(parent_x, parent_y, nx, ny);
+            
+            if (!_lazy && parent != current && !line_of_sight(parent, id, width, _diagonal))
+            {
+                via = current;
+                total_cost = g[current] + (i < 4 ? 1.0 : diagonal_step);
+            }
+            
+            if (state == OPEN && total_cost >= g[id])
+                continue;
+            
+            g[id] = total_cost;
+            parents[id] = via;
+            
+            const double f = total_cost + distance(nx, ny, _goal.x, _goal.y);
+            
+            if (state == OPEN)
+            {
+                open.decrease(id, f, total_cost);
+            }
+            else
+            {
+                stamps[id] = generation;
+                states[id] = OPEN;
+                open.push(id, f, total_cost);
+            }
+        }
+    }
+    
+    open.clear();
+    
+    if (!found)
+        return {};
+    
+    cost = g[goal];
+    
+    vector2_array_i path;
+    
+    for (uint32_t id = goal; ; id = parents[id])
+    {
+        path.push_back({ static_cast<int>(id % width), static_cast<int>(id / width) });
+        
+        if (id == start)
+            break;
+    }
+    
+    return path;
+}
+
+bool any_angle_search::line_of_sight(uint32_t _from, uint32_t _to, int _width, bool _diagonal)
+{
+    if (_from == _to)
+        return true;
+    
+    ++line_checks;
+    
+    return has_line_of_sight(walls, 
+        { static_cast<int>(_from % _width), static_cast<int>(_from / _width) }, 
+        { static_cast<int>(_to % _width), static_cast<int>(_to / _width) }, 
+        _diagonal);
+}
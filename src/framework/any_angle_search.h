@@ -0,0 +1,91 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ANY_ANGLE_SEARCH_H
+#define ANY_ANGLE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Theta* and Lazy Theta* over the cells of an occupancy grid.
+ * 
+ * Like A*, but a cell may take the parent of the cell that reached it 
+ * whenever the straight line between them is free, so paths bend only at 
+ * corners of obstacles and come back as waypoints instead of every cell.  
+ * Costs are euclidean distances between cell centers.  Theta* checks the 
+ * line for every generated cell.  Lazy Theta* assumes it and only checks 
+ * once per expansion.  When the line is blocked, it falls back to the best 
+ * expanded neighbor and queues the cell again at its new cost.
+ */
+class any_angle_search
+{
+    
+public:
+    
+    explicit any_angle_search(const occupancy_grid& _walls);
+    
+    // Waypoints from _goal back to _start, empty if the goal is unreachable
+    vector2_array_i find_path(vector2_i _start, vector2_i _goal, bool _diagonal, bool _lazy);
+    
+    inline std::size_t get_expansions() const { return expansions; }
+    inline std::size_t get_line_checks() const { return line_checks; }
+    
+    // Length of the last path in cells
+    inline double get_cost() const { return cost; }
+    
+private:
+    
+    enum cell_state : uint8_t
+    {
+        UNSEEN,
+        OPEN,
+        CLOSED
+    };
+    
+    const occupancy_grid& walls;
+    std::size_t expansions;
+    std::size_t line_checks;
+    double cost;
+    
+    std::vector<double> g;
+    std::vector<uint32_t> parents;
+    std::vector<uint8_t> states;
+    std::vector<uint32_t> stamps;       // cells are UNSEEN unless stamped with the current search
+    uint32_t generation;
+    indexed_heap<double, 2> open;
+    
+    inline uint8_t get_state(uint32_t _id) const
+    {
+        return (stamps[_id] == generation ? states[_id] : static_cast<uint8_t>(UNSEEN));
+    }
+    
+    bool line_of_sight(uint32_t _from, uint32_t _to, int _width, bool _diagonal);
+    
+};
+
+#endif /* ANY_ANGLE_SEARCH_H */
@@ -0,0 +1,302 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "anytime_search.h"
+#include <algorithm>
+#include <limits>
+
+anytime_search::anytime_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , initial_weight(3.0)
+    , weight_step(0.5)
+    , weight(3.0)
+    , bound(std::numeric_limits<double>::infinity())
+    , cost(-1)
+    , expansions(0)
+    , passes(0)
+    , pass(0)
+    , start({ 0, 0 })
+    , goal({ 0, 0 })
+    , width(0)
+    , directions(4)
+    , active(false)
+    , searching(false)
+    , finished(false)
+{}
+
+void anytime_search::set_weights(double _initial, double _step)
+{
+    initial_weight = std::max(1.0, _initial);
+    weight_step = std::max(0.01, _step);
+    active = false;
+}
+
+void anytime_search::invalidate_all()
+{
+    active = false;
+}
+
+vector2_array_i anytime_search::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic
+    , clock::time_point _deadline)
+{
+    expansions = 0;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+    {
+        active = false;
+        bound = std::numeric_limits<double>::infinity();
+        cost = -1;
+        return {};
+    }
+    
+    if (_start == static_cast<vector2_i>(_goal))
+    {
+        active = false;
+        bound = 1.0;
+        cost = 0;
+        return { _start };
+    }
+    
+    // Another query, or the same one on a resized world
+    if (!active 
+        || _start != static_cast<vector2_i>(start) 
+        || _goal != static_cast<vector2_i>(goal)
+        || directions != (_diagonal ? 8 : 4)
+        || width != walls.get_size().x
+        || closed.size() != static_cast<std::size_t>(walls.get_size().x) * walls.get_size().y)
+    {
+        heuristic = _heuristic;
+        begin(_start, _goal, _diagonal);
+    }
+    
+    const uint32_t goal_id = cell_index(goal.x, goal.y);
+    
+    while (!finished)
+    {
+        if (searching && !improve_path(_deadline))
+            break;
+        
+        if (cells.get_state(goal_id) == node_state::NONE)
+        {
+            // The first pass ran out of cells, there is no path at all
+            finished = true;
+            bound = std::numeric_limits<double>::infinity();
+            break;
+        }
+        
+        ++passes;
+        next_pass();
+        
+        if (clock::now() >= _deadline)
+            break;
+    }
+    
+    if (passes == 0)
+    {
+        cost = -1;
+        return {};
+    }
+    
+    // A pass cut short may have lowered cells of the path after their 
+    // children took them as parent, so the cost is that of the path itself
+    return trace_path();
+}
+
+void anytime_search::begin(vector2_i _start, vector2_i _goal, bool _diagonal)
+{
+    const vector2_i size = walls.get_size();
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+    
+    start = _start;
+    goal = _goal;
+    width = size.x;
+    directions = (_diagonal ? 8 : 4);
+    
+    if (closed.size() != count)
+    {
+        closed.assign(count, 0);
+        listed.assign(count, 0);
+        pass = 0;
+    }
+    
+    cells.resize(count);
+    cells.reset();
+    open.reset(count);
+    queued.clear();
+    inconsistent.clear();
+    
+    weight = initial_weight;
+    bound = std::numeric_limits<double>::infinity();
+    cost = -1;
+    passes = 0;
+    ++pass;
+    
+    const uint32_t id = cell_index(start.x, start.y);
+    cells.open(id, 0, search_grid::no_parent);
+    open.push(id, priority(id), 0);
+    queued.push_back(id);
+    
+    active = true;
+    searching = true;
+    finished = false;
+}
+
+// One weighted A* pass, false if the deadline cut it short
+bool anytime_search::improve_path(clock::time_point _deadline)
+{
+    const uint32_t goal_id = cell_index(goal.x, goal.y);
+    std::size_t steps = 0;
+    
+    while (!open.empty())
+    {
+        // The goal has h = 0, so its g is its f
+        if (cells.get_state(goal_id) != node_state::NONE && cells.get_g(goal_id) <= open.top_f())
+            break;
+        
+        if ((++steps & 0x7F) == 0 && clock::now() >= _deadline)
+            return false;
+        
+        const uint32_t current = open.pop();
+        const int x = static_cast<int>(current) % width;
+        const int y = static_cast<int>(current) / width;
+        const int32_t g = cells.get_g(current);
+        
+        closed[current] = pass;
+        ++expansions;
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = cell_index(nx, ny);
+            const int32_t total_cost = g + (i < 4 ? 10 : 14);
+            
+            if (cells.get_state(id) != node_state::NONE && total_cost >= cells.get_g(id))
+                continue;
+            
+            cells.open(id, total_cost, static_cast<uint8_t>(i));
+            
+            // Closed cells wait for the next pass instead of being reopened
+            if (closed[id] == pass)
+            {
+                if (listed[id] != pass)
+                {
+                    listed[id] = pass;
+                    inconsistent.push_back(id);
+                }
+            }
+            else if (open.contains(id))
+            {
+                open.decrease(id, priority(id), total_cost);
+            }
+            else
+            {
+                open.push(id, priority(id), total_cost);
+                queued.push_back(id);
+            }
+        }
+    }
+    
+    searching = false;
+    
+    return true;
+}
+
+// Tightens the bound of the finished pass and queues the next, lower weight
+void anytime_search::next_pass()
+{
+    const int32_t goal_g = cells.get_g(cell_index(goal.x, goal.y));
+    double lower = goal_g;
+    
+    std::vector<uint32_t> pending;
+    pending.reserve(open.size() + inconsistent.size());
+    
+    for (uint32_t id : queued)
+        if (open.contains(id))
+            pending.push_back(id);
+    
+    pending.insert(pending.end(), inconsistent.begin(), inconsistent.end());
+    
+    for (uint32_t id : pending)
+    {
+        const vector2_i position = { static_cast<int>(id) % width, static_cast<int>(id) / width };
+        lower = std::min(lower, static_cast<double>(cells.get_g(id) + heuristic(position, goal)));
+    }
+    
+    bound = std::min(weight, (lower > 0 ? goal_g / lower : 1.0));
+    
+    if (bound <= 1.0 || weight <= 1.0)
+    {
+        bound = std::max(1.0, bound);
+        finished = true;
+        return;
+    }
+    
+    weight = std::max(1.0, weight - weight_step);
+    ++pass;
+    
+    open.clear();
+    queued.clear();
+    inconsistent.clear();
+    
+    for (uint32_t id : pending)
+    {
+        open.push(id, priority(id), cells.get_g(id));
+        queued.push_back(id);
+    }
+    
+    searching = true;
+}
+
+vector2_array_i anytime_search::trace_path()
+{
+    vector2_array_i path;
+    int x = goal.x;
+    int y = goal.y;
+    
+    cost = 0;
+    
+    for (;;)
+    {
+        path.push_back({ x, y });
+        
+        uint8_t parent = cells.get_parent(cell_index(x, y));
+        
+        if (parent == search_grid::no_parent)
+            break;
+        
+        cost += (parent < 4 ? 10 : 14);
+        x -= grid_direction_x[parent];
+        y -= grid_direction_y[parent];
+    }
+    
+    return path;
+}
@@ -0,0 +1,130 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ANYTIME_SEARCH_H
+#define ANYTIME_SEARCH_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Anytime Repairing A* (ARA*) over an occupancy grid.
+ * 
+ * The first pass runs weighted A* with f = g + epsilon * h and yields a path
+ * at most epsilon times longer than optimal.  Each later pass lowers epsilon
+ * and reuses the g values of the passes before it, so only cells whose cost 
+ * improved are expanded again.  Passes stop at the deadline, and the next 
+ * call for the same query picks up where the last one stopped.  Any 
+ * collision change starts the query over.
+ */
+class anytime_search
+{
+    
+public:
+    
+    typedef std::chrono::steady_clock clock;
+    
+    explicit anytime_search(const occupancy_grid& _walls);
+    
+    // Weight of the first pass and how much each pass lowers it, 3 and 0.5 by default
+    void set_weights(double _initial, double _step);
+    
+    // Drops the search state of the last query
+    void invalidate_all();
+    
+    // Best path from _goal back to _start found before _deadline, empty if 
+    // none was found yet or the goal is unreachable
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic
+        , clock::time_point _deadline);
+    
+    // Upper bound on cost / optimal cost of the last path, infinity if there is none
+    inline double get_bound() const { return bound; }
+    
+    // Cost of the last path in the 10/14 units of the search, -1 if there is none
+    inline int32_t get_cost() const { return cost; }
+    
+    // Cells expanded by the last call to find_path
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    // Passes finished for the current query
+    inline std::size_t get_passes() const { return passes; }
+    
+private:
+    
+    const occupancy_grid& walls;
+    search_grid cells;                  // g and parent of every cell seen by the query
+    indexed_heap<double, 2> open;
+    std::vector<uint32_t> closed;       // pass that closed the cell
+    std::vector<uint32_t> listed;       // pass whose inconsistent list holds the cell
+    std::vector<uint32_t> queued;       // cells pushed to open during this pass
+    std::vector<uint32_t> inconsistent; // closed cells whose g dropped during this pass
+    std::function<int(vector2_i, vector2_i)> heuristic;
+    
+    double initial_weight;
+    double weight_step;
+    double weight;
+    double bound;
+    int32_t cost;
+    std::size_t expansions;
+    std::size_t passes;
+    uint32_t pass;
+    vector2_i start;
+    vector2_i goal;
+    int width;
+    int directions;
+    bool active;        // a query is in progress
+    bool searching;     // the current pass has not finished
+    bool finished;      // no pass can improve the path anymore
+    
+    inline uint32_t cell_index(int _x, int _y) const 
+    { 
+        return static_cast<uint32_t>(_y * width + _x); 
+    }
+    
+    inline double priority(uint32_t _id) const
+    {
+        const vector2_i position = { static_cast<int>(_id) % width, static_cast<int>(_id) / width };
+        return cells.get_g(_id) + weight * heuristic(position, goal);
+    }
+    
+    void begin(vector2_i _start, vector2_i _goal, bool _diagonal);
+    void next_pass();
+    bool improve_path(clock::time_point _deadline);
+    
+    // Path from the goal along the parents, and its cost
+    vector2_array_i trace_path();
+    
+};
+
+#endif /* ANYTIME_SEARCH_H */
@@ -0,0 +1,72 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ASTAR_SEARCH_H
+#define ASTAR_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <framework/search_kernel.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * A* over an occupancy grid with its own cell arrays and open list.
+ * 
+ * Runs the same search kernel as the cell-array backend of path_builder, 
+ * but only reads the grid, so one instance per thread can share a world.
+ */
+class astar_search
+{
+    
+public:
+    
+    explicit astar_search(const occupancy_grid& _walls);
+    
+    // Fills _path from _goal back to _start, keeping its capacity.  An 
+    // unreachable goal gives the path to the last expanded cell, like find_path.
+    void find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , heuristic_type _type
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic
+        , const distance_table& _euclidean
+        , vector2_array_i& _path);
+    
+    // Cells expanded by the last call to find_path
+    inline std::size_t get_expansions() const { return expansions; }
+    
+private:
+    
+    const occupancy_grid& walls;
+    search_grid cells;
+    indexed_heap<double, 2> open;
+    std::size_t expansions;
+    
+};
+
+#endif /* ASTAR_SEARCH_H */
@@ -0,0 +1,181 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bidirectional_search.h"
+#include <algorithm>
+#include <limits>
+
+bidirectional_search::bidirectional_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , expansions(0)
+    , width(0)
+    , directions(4)
+    , best(0)
+    , meeting(0)
+{}
+
+vector2_array_i bidirectional_search::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    expansions = 0;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    if (_start == static_cast<vector2_i>(_goal))
+        return { _start };
+    
+    width = walls.get_size().x;
+    directions = (_diagonal ? 8 : 4);
+    best = std::numeric_limits<int32_t>::max();
+    
+    const std::size_t count = static_cast<std::size_t>(width) * walls.get_size().y;
+    
+    forward.target = _goal;
+    forward.origin = _start;
+    backward.target = _start;
+    backward.origin = _goal;
+    
+    for (auto side : { &forward, &backward })
+    {
+        side->cells.resize(count);
+        side->cells.reset();
+        side->open.reset(count);
+    }
+    
+    const uint32_t start = cell_index(_start.x, _start.y);
+    const uint32_t goal = cell_index(_goal.x, _goal.y);
+    
+    forward.cells.open(start, 0, search_grid::no_parent);
+    forward.open.push(start, potential(forward, _start, _heuristic), 0);
+    backward.cells.open(goal, 0, search_grid::no_parent);
+    backward.open.push(goal, potential(backward, _goal, _heuristic), 0);
+    
+    // With balanced potentials both sides search the same reduced-cost graph,
+    // so the two top keys together bound every path not found yet
+    while (!forward.open.empty() && !backward.open.empty())
+    {
+        if (forward.open.top_f() + backward.open.top_f() >= best)
+            break;
+        
+        if (forward.open.size() <= backward.open.size())
+            expand(forward, backward, _heuristic);
+        else
+            expand(backward, forward, _heuristic);
+    }
+    
+    forward.open.clear();
+    backward.open.clear();
+    
+    if (best == std::numeric_limits<int32_t>::max())
+        return {};
+    
+    // Goal side first, then the start side, as find_path orders cells
+    vector2_array_i path;
+    int x = static_cast<int>(meeting) % width;
+    int y = static_cast<int>(meeting) / width;
+    
+    for (;;)
+    {
+        path.push_back({ x, y });
+        
+        uint8_t parent = backward.cells.get_parent(cell_index(x, y));
+        
+        if (parent == search_grid::no_parent)
+            break;
+        
+        x -= grid_direction_x[parent];
+        y -= grid_direction_y[parent];
+    }
+    
+    std::reverse(path.begin(), path.end());
+    
+    x = static_cast<int>(meeting) % width;
+    y = static_cast<int>(meeting) / width;
+    
+    for (;;)
+    {
+        uint8_t parent = forward.cells.get_parent(cell_index(x, y));
+        
+        if (parent == search_grid::no_parent)
+            break;
+        
+        x -= grid_direction_x[parent];
+        y -= grid_direction_y[parent];
+        path.push_back({ x, y });
+    }
+    
+    return path;
+}
+
+void bidirectional_search::expand(
+      frontier& _side
+    , const frontier& _other
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    const uint32_t current = _side.open.pop();
+    const int x = static_cast<int>(current) % width;
+    const int y = static_cast<int>(current) / width;
+    const int32_t g = _side.cells.get_g(current);
+    
+    ++expansions;
+    _side.cells.close(current);
+    
+    for (int i = 0; i < directions; ++i)
+    {
+        const int nx = x + grid_direction_x[i];
+        const int ny = y + grid_direction_y[i];
+        
+        if (walls.is_blocked(nx, ny))
+            continue;
+        
+        const uint32_t id = cell_index(nx, ny);
+        const node_state state = _side.cells.get_state(id);
+        const int32_t total_cost = g + (i < 4 ? 10 : 14);
+        
+        if (state == node_state::IN_CLOSED_LIST)
+            continue;
+        
+        if (state == node_state::IN_OPEN_LIST && total_cost >= _side.cells.get_g(id))
+            continue;
+        
+        const double f = total_cost + potential(_side, { nx, ny }, _heuristic);
+        
+        if (state == node_state::IN_OPEN_LIST)
+            _side.open.decrease(id, f, total_cost);
+        else
+            _side.open.push(id, f, total_cost);
+        
+        _side.cells.open(id, total_cost, static_cast<uint8_t>(i));
+        
+        // Both sides have reached this cell, so it joins a full path
+        if (_other.cells.get_state(id) != node_state::NONE && total_cost + _other.cells.get_g(id) < best)
+        {
+            best = total_cost + _other.cells.get_g(id);
+            meeting = id;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BIDIRECTIONAL_SEARCH_H
+#define BIDIRECTIONAL_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Bidirectional A* over an occupancy grid.
+ * 
+ * One search grows from the start toward the goal and one from the goal 
+ * toward the start, each with its own open list and cell arrays.  The side 
+ * with the smaller open list expands next.  Whenever a side reaches a cell 
+ * the other side has seen, the joined cost becomes a candidate.
+ * 
+ * Both sides are keyed on the balanced potential (h(v, target) - h(v, origin)) / 2
+ * so that they agree on one reduced-cost graph.  The search stops once the 
+ * sum of the two smallest keys reaches the best candidate, which keeps paths 
+ * optimal as long as the heuristic is consistent, like manhattan with 4 
+ * directions and octagonal.
+ */
+class bidirectional_search
+{
+    
+public:
+    
+    explicit bidirectional_search(const occupancy_grid& _walls);
+    
+    // Every cell of the path from _goal back to _start, empty if unreachable
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    // Cells expanded by both sides in the last call to find_path
+    inline std::size_t get_expansions() const { return expansions; }
+    
+private:
+    
+    struct frontier
+    {
+        search_grid cells;
+        indexed_heap<double, 2> open;
+        vector2_i target;   // cell the side searches toward
+        vector2_i origin;   // cell the side started from
+    };
+    
+    const occupancy_grid& walls;
+    frontier forward;
+    frontier backward;
+    std::size_t expansions;
+    int width;
+    int directions;
+    
+    int32_t best;
+    uint32_t meeting;
+    
+    inline uint32_t cell_index(int _x, int _y) const 
+    { 
+        return static_cast<uint32_t>(_y * width + _x); 
+    }
+    
+    inline double potential(
+          const frontier& _side
+        , vector2_i _coordinates
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic) const
+    {
+        return 0.5 * (_heuristic(_coordinates, _side.target) - _heuristic(_coordinates, _side.origin));
+    }
+    
+    void expand(
+          frontier& _side
+        , const frontier& _other
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+};
+
+#endif /* BIDIRECTIONAL_SEARCH_H */
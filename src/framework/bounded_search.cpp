@@ -0,0 +1,281 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bounded_search.h"
+#include <algorithm>
+#include <limits>
+
+bounded_search::bounded_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , weight(1.2)
+    , bound(std::numeric_limits<double>::infinity())
+    , cost(-1)
+    , expansions(0)
+    , width(0)
+{}
+
+void bounded_search::set_epsilon(double _epsilon)
+{
+    weight = 1.0 + std::max(0.0, _epsilon);
+}
+
+vector2_array_i bounded_search::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic
+    , bool _focal)
+{
+    expansions = 0;
+    bound = std::numeric_limits<double>::infinity();
+    cost = -1;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    if (_start == static_cast<vector2_i>(_goal))
+    {
+        bound = 1.0;
+        cost = 0;
+        return { _start };
+    }
+    
+    const vector2_i size = walls.get_size();
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+    
+    width = size.x;
+    cells.resize(count);
+    cells.reset();
+    
+    if (h.size() != count)
+        h.assign(count, 0);
+    
+    const uint32_t start_id = cell_index(_start.x, _start.y);
+    const uint32_t goal_id = cell_index(_goal.x, _goal.y);
+    const int directions = (_diagonal ? 8 : 4);
+    
+    const int32_t lower = (_focal 
+        ? search_focal(start_id, goal_id, directions, _goal, _heuristic)
+        : search_weighted(start_id, goal_id, directions, _goal, _heuristic));
+    
+    if (lower < 0)
+        return {};
+    
+    cost = cells.get_g(goal_id);
+    bound = (lower > 0 ? std::max(1.0, static_cast<double>(cost) / lower) : 1.0);
+    
+    // Weighted A* never reopens cells, so its lower bound alone may be loose
+    if (!_focal)
+        bound = std::min(bound, weight);
+    
+    return trace_path(_goal);
+}
+
+// Returns a lower bound on the optimal cost, -1 if the goal is unreachable
+int32_t bounded_search::search_weighted(
+      uint32_t _start
+    , uint32_t _goal
+    , int _directions
+    , vector2_i _target
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    weighted.reset(h.size());
+    inconsistent.clear();
+    
+    std::vector<uint32_t> queued;
+    
+    h[_start] = _heuristic({ static_cast<int>(_start) % width, static_cast<int>(_start) / width }, _target);
+    cells.open(_start, 0, search_grid::no_parent);
+    weighted.push(_start, weight * h[_start], 0.0);
+    queued.push_back(_start);
+    
+    while (!weighted.empty())
+    {
+        const uint32_t current = weighted.pop();
+        
+        if (current == _goal)
+        {
+            // Every optimal path still runs through an open cell or a 
+            // closed cell whose cheaper cost was never propagated
+            int32_t lower = cells.get_g(_goal);
+            
+            for (uint32_t id : queued)
+                if (weighted.contains(id))
+                    lower = std::min(lower, cells.get_g(id) + h[id]);
+            
+            for (const auto& item : inconsistent)
+                lower = std::min(lower, item.second + h[item.first]);
+            
+            return lower;
+        }
+        
+        const int x = static_cast<int>(current) % width;
+        const int y = static_cast<int>(current) / width;
+        const int32_t g = cells.get_g(current);
+        
+        cells.close(current);
+        ++expansions;
+        
+        for (int i = 0; i < _directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = cell_index(nx, ny);
+            const int32_t total_cost = g + (i < 4 ? 10 : 14);
+            const node_state state = cells.get_state(id);
+            
+            if (state == node_state::NONE)
+            {
+                h[id] = _heuristic({ nx, ny }, _target);
+                cells.open(id, total_cost, static_cast<uint8_t>(i));
+                weighted.push(id, total_cost + weight * h[id], total_cost);
+                queued.push_back(id);
+                continue;
+            }
+            
+            if (total_cost >= cells.get_g(id))
+                continue;
+            
+            // Closed cells are not reopened, they only loosen the lower bound
+            if (state == node_state::IN_CLOSED_LIST)
+            {
+                inconsistent.push_back({ id, total_cost });
+                continue;
+            }
+            
+            cells.open(id, total_cost, static_cast<uint8_t>(i));
+            weighted.decrease(id, total_cost + weight * h[id], total_cost);
+        }
+    }
+    
+    return -1;
+}
+
+// Returns a lower bound on the optimal cost, -1 if the goal is unreachable
+int32_t bounded_search::search_focal(
+      uint32_t _start
+    , uint32_t _goal
+    , int _directions
+    , vector2_i _target
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    open.reset(h.size());
+    waiting.reset(h.size());
+    focal.reset(h.size());
+    
+    h[_start] = _heuristic({ static_cast<int>(_start) % width, static_cast<int>(_start) / width }, _target);
+    cells.open(_start, 0, search_grid::no_parent);
+    open.push(_start, h[_start], 0);
+    waiting.push(_start, h[_start], 0);
+    
+    while (!open.empty())
+    {
+        // The smallest f only grows, so cells join focal once and stay
+        const int32_t f_min = open.top_f();
+        const double limit = weight * f_min;
+        
+        while (!waiting.empty() && waiting.top_f() <= limit)
+        {
+            const int32_t g = waiting.top_g();
+            const uint32_t id = waiting.pop();
+            focal.push(id, g + weight * h[id], g);
+        }
+        
+        const uint32_t current = focal.pop();
+        open.remove(current);
+        
+        if (current == _goal)
+            return f_min;
+        
+        const int x = static_cast<int>(current) % width;
+        const int y = static_cast<int>(current) / width;
+        const int32_t g = cells.get_g(current);
+        
+        cells.close(current);
+        ++expansions;
+        
+        for (int i = 0; i < _directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = cell_index(nx, ny);
+            const int32_t total_cost = g + (i < 4 ? 10 : 14);
+            const node_state state = cells.get_state(id);
+            
+            if (state == node_state::NONE)
+                h[id] = _heuristic({ nx, ny }, _target);
+            else if (total_cost >= cells.get_g(id))
+                continue;
+            
+            // Cells expanded out of f order may be found cheaper later, 
+            // and are reopened so the smallest f stays a lower bound
+            cells.open(id, total_cost, static_cast<uint8_t>(i));
+            
+            if (!open.contains(id))
+            {
+                open.push(id, total_cost + h[id], total_cost);
+                waiting.push(id, total_cost + h[id], total_cost);
+                continue;
+            }
+            
+            open.decrease(id, total_cost + h[id], total_cost);
+            
+            if (focal.contains(id))
+                focal.update(id, total_cost + weight * h[id], total_cost);
+            else
+                waiting.decrease(id, total_cost + h[id], total_cost);
+        }
+    }
+    
+    return -1;
+}
+
+vector2_array_i bounded_search::trace_path(vector2_i _goal) const
+{
+    vector2_array_i path;
+    int x = _goal.x;
+    int y = _goal.y;
+    
+    for (;;)
+    {
+        path.push_back({ x, y });
+        
+        uint8_t parent = cells.get_parent(cell_index(x, y));
+        
+        if (parent == search_grid::no_parent)
+            break;
+        
+        x -= grid_direction_x[parent];
+        y -= grid_direction_y[parent];
+    }
+    
+    return path;
+}
@@ -0,0 +1,109 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BOUNDED_SEARCH_H
+#define BOUNDED_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Bounded-suboptimal A* over an occupancy grid, in two flavors.
+ * 
+ * Weighted A* orders the open list on g + (1 + epsilon) * h and never 
+ * reopens a closed cell, which keeps the bound for consistent heuristics.  
+ * Focal search (A* epsilon) keeps the open list on f = g + h and expands, 
+ * among the open cells with f <= (1 + epsilon) times the smallest f, the 
+ * one weighted A* would pick.  It reopens cells found cheaper, so the bound 
+ * holds for any heuristic that never overestimates, and its paths are 
+ * usually closer to optimal.  After each search the engine also reports 
+ * how close to optimal the path is proven to be, often well under the bound.
+ */
+class bounded_search
+{
+    
+public:
+    
+    explicit bounded_search(const occupancy_grid& _walls);
+    
+    // Allowed suboptimality, 0.2 by default.  0 searches like A*.
+    void set_epsilon(double _epsilon);
+    inline double get_epsilon() const { return weight - 1.0; }
+    
+    // Path from _goal back to _start, empty if the goal is unreachable
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic
+        , bool _focal);
+    
+    // Upper bound on cost / optimal cost of the last path, infinity if there 
+    // is none.  At most 1 + epsilon when the heuristic is consistent.
+    inline double get_bound() const { return bound; }
+    
+    // Cost of the last path in the 10/14 units of the search, -1 if there is none
+    inline int32_t get_cost() const { return cost; }
+    
+    inline std::size_t get_expansions() const { return expansions; }
+    
+private:
+    
+    const occupancy_grid& walls;
+    double weight;
+    double bound;
+    int32_t cost;
+    std::size_t expansions;
+    int width;
+    
+    search_grid cells;
+    std::vector<int32_t> h;                         // heuristic of every cell the search has seen
+    indexed_heap<int32_t, 2> open;                  // open cells on g + h, focal search only
+    indexed_heap<int32_t, 2> waiting;               // open cells not yet in focal, on g + h
+    indexed_heap<double, 2> focal;                  // open cells within the bound, on g + weight * h
+    indexed_heap<double, 2> weighted;               // open cells on g + weight * h
+    std::vector<std::pair<uint32_t, int32_t>> inconsistent;  // closed cells weighted A* found cheaper
+    
+    inline uint32_t cell_index(int _x, int _y) const
+    {
+        return static_cast<uint32_t>(_y * width + _x);
+    }
+    
+    int32_t search_weighted(uint32_t _start, uint32_t _goal, int _directions, vector2_i _target, 
+        const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    int32_t search_focal(uint32_t _start, uint32_t _goal, int _directions, vector2_i _target, 
+        const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    vector2_array_i trace_path(vector2_i _goal) const;
+    
+};
+
+#endif /* BOUNDED_SEARCH_H */
@@ -0,0 +1,213 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <assert.h>
+
+/*
+ * Open list of grid cells bucketed by integer f = g + h (Dial's algorithm).
+ * 
+ * Each bucket is a doubly linked list threaded through per-cell arrays, so 
+ * push, decrease-key and removal are O(1).  Pop takes the newest cell of 
+ * the lowest bucket, which prefers deeper cells on ties much like the 
+ * larger-g rule of indexed_heap.  A consistent heuristic never lowers f, so 
+ * the scan for the lowest bucket only moves forward and costs O(1) 
+ * amortized.  Inconsistent heuristics still work, they just move the scan 
+ * back.  Keys must be small non-negative integers, there is one bucket per 
+ * possible value.  The interface matches indexed_heap, so the search 
+ * kernel takes either.
+ */
+template<typename T = int32_t>
+class bucket_queue
+{
+    
+public:
+    
+    static const uint32_t npos = UINT32_MAX;
+    
+    explicit bucket_queue() : count(0), lowest(0), highest(0) {}
+    
+    // Sizes the per-cell arrays for a grid of _cells and empties the queue
+    void reset(std::size_t _cells)
+    {
+        clear();
+        
+        if (keys.size() != _cells)
+        {
+            keys.assign(_cells, unqueued);
+            next.assign(_cells, npos);
+            previous.assign(_cells, npos);
+        }
+    }
+    
+    // Empties the queue, touching only the buckets that may still hold cells
+    void clear()
+    {
+        for (std::size_t bucket = lowest; count > 0 && bucket <= highest; ++bucket)
+        {
+            for (uint32_t id = heads[bucket]; id != npos; id = next[id])
+            {
+                keys[id] = unqueued;
+                --count;
+            }
+            
+            heads[bucket] = npos;
+        }
+        
+        count = 0;
+        lowest = heads.size();
+        highest = 0;
+    }
+    
+    inline bool empty() const { return count == 0; }
+    inline std::size_t size() const { return count; }
+    
+    inline bool contains(uint32_t _id) const 
+    { 
+        return (_id < keys.size() && keys[_id] != unqueued); 
+    }
+    
+    inline uint32_t top()
+    {
+        assert(count > 0);
+        seek();
+        return heads[lowest];
+    }
+    
+    inline T top_f()
+    {
+        assert(count > 0);
+        seek();
+        return static_cast<T>(lowest);
+    }
+    
+    // The g cost only breaks ties in the heaps, buckets break them by age
+    inline void push(uint32_t _id, T _f, T)
+    {
+        assert(!contains(_id));
+        
+        link(_id, _f);
+        ++count;
+    }
+    
+    inline void decrease(uint32_t _id, T _f, T)
+    {
+        assert(contains(_id));
+        
+        unlink(_id);
+        link(_id, _f);
+    }
+    
+    inline void update(uint32_t _id, T _f, T _g)
+    {
+        decrease(_id, _f, _g);
+    }
+    
+    inline void remove(uint32_t _id)
+    {
+        assert(contains(_id));
+        
+        unlink(_id);
+        keys[_id] = unqueued;
+        --count;
+    }
+    
+    inline uint32_t pop()
+    {
+        assert(count > 0);
+        seek();
+        
+        const uint32_t id = heads[lowest];
+        remove(id);
+        
+        return id;
+    }
+    
+private:
+    
+    static const uint32_t unqueued = UINT32_MAX;
+    
+    std::vector<uint32_t> heads;        // f -> newest cell of the bucket
+    std::vector<uint32_t> keys;         // cell id -> bucket, unqueued when not in the list
+    std::vector<uint32_t> next;         // cell id -> older cell of the same bucket
+    std::vector<uint32_t> previous;     // cell id -> newer cell of the same bucket
+    std::size_t count;
+    std::size_t lowest;                 // no bucket below holds a cell
+    std::size_t highest;                // no bucket above holds a cell
+    
+    inline void seek()
+    {
+        while (heads[lowest] == npos)
+            ++lowest;
+    }
+    
+    inline void link(uint32_t _id, T _f)
+    {
+        const std::size_t bucket = (_f > 0 ? static_cast<std::size_t>(_f) : 0);
+        
+        if (bucket >= heads.size())
+            heads.resize(bucket + 1 + heads.size() / 2, npos);
+        
+        keys[_id] = static_cast<uint32_t>(bucket);
+        next[_id] = heads[bucket];
+        previous[_id] = npos;
+        
+        if (heads[bucket] != npos)
+            previous[heads[bucket]] = _id;
+        
+        heads[bucket] = _id;
+        
+        if (bucket < lowest)
+            lowest = bucket;
+        
+        if (bucket > highest)
+            highest = bucket;
+    }
+    
+    inline void unlink(uint32_t _id)
+    {
+        const uint32_t bucket = keys[_id];
+        
+        if (previous[_id] != npos)
+            next[previous[_id]] = next[_id];
+        else
+            heads[bucket] = next[_id];
+        
+        if (next[_id] != npos)
+            previous[next[_id]] = previous[_id];
+    }
+    
+};
+
+template<typename T>
+const uint32_t bucket_queue<T>::npos;
+
+template<typename T>
+const uint32_t bucket_queue<T>::unqueued;
+
+#endif /* BUCKET_QUEUE_H */
@@ -0,0 +1,342 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "connected_components.h"
+#include <algorithm>
+#include <framework/search_grid.h>
+
+namespace
+{
+    // Cells a detour search around a newly blocked cell may visit
+    const std::size_t detour_limit = 256;
+}
+
+const uint32_t connected_components::none;
+
+connected_components::connected_components(const occupancy_grid& _walls) :
+      walls(_walls)
+    , size({ 0, 0 })
+    , diagonal(false)
+    , valid(false)
+    , detour(0)
+    , relabeled_cells(0)
+{}
+
+void connected_components::invalidate_all()
+{
+    valid = false;
+    splits.clear();
+}
+
+void connected_components::block(vector2_i _coordinates)
+{
+    if (!valid || _coordinates.x < 0 || _coordinates.y < 0 || _coordinates.x >= size.x || _coordinates.y >= size.y)
+        return;
+    
+    uint32_t& label = labels[cell_index(_coordinates.x, _coordinates.y)];
+    
+    if (label == none)
+        return;
+    
+    --sizes[label];
+    label = none;
+    
+    if (is_ring_joined(_coordinates) || find_detour(_coordinates))
+        return;
+    
+    // Every piece the region may have split into touches the blocked cell
+    const int directions = (diagonal ? 8 : 4);
+    
+    for (int i = 0; i < directions; ++i)
+    {
+        const int nx = _coordinates.x + grid_direction_x[i];
+        const int ny = _coordinates.y + grid_direction_y[i];
+        
+        if (!walls.is_blocked(nx, ny))
+            splits.push_back({ nx, ny });
+    }
+    
+    // Flooding everything once is cheaper than flooding most regions again
+    if (splits.size() > labels.size() / 8)
+        invalidate_all();
+}
+
+void connected_components::unblock(vector2_i _coordinates)
+{
+    if (!valid || _coordinates.x < 0 || _coordinates.y < 0 || _coordinates.x >= size.x || _coordinates.y >= size.y)
+        return;
+    
+    const int directions = (diagonal ? 8 : 4);
+    uint32_t largest = none;
+    
+    for (int i = 0; i < directions; ++i)
+    {
+        const uint32_t label = get_label({ _coordinates.x + grid_direction_x[i], _coordinates.y + grid_direction_y[i] });
+        
+        if (label != none && (largest == none || sizes[label] > sizes[largest]))
+            largest = label;
+    }
+    
+    // An isolated cell starts a region of its own
+    if (largest == none)
+    {
+        labels[cell_index(_coordinates.x, _coordinates.y)] = static_cast<uint32_t>(sizes.size());
+        sizes.push_back(1);
+        return;
+    }
+    
+    labels[cell_index(_coordinates.x, _coordinates.y)] = largest;
+    ++sizes[largest];
+    
+    // The smaller regions take the label of the largest one
+    for (int i = 0; i < directions; ++i)
+    {
+        const vector2_i neighbor = { _coordinates.x + grid_direction_x[i], _coordinates.y + grid_direction_y[i] };
+        const uint32_t label = get_label(neighbor);
+        
+        if (label != none && label != largest)
+            sizes[largest] += flood(neighbor, largest);
+    }
+}
+
+void connected_components::update(bool _diagonal)
+{
+    // Labels retired by floods are not reused, so compact them now and then
+    if (!valid 
+        || diagonal != _diagonal 
+        || walls.get_size() != static_cast<vector2_i>(size) 
+        || sizes.size() > 2 * labels.size() + 64)
+    {
+        diagonal = _diagonal;
+        rebuild();
+        return;
+    }
+    
+    // Each piece gets a fresh label, floods from cells of a piece already 
+    // labeled by this update are skipped
+    const uint32_t first_label = static_cast<uint32_t>(sizes.size());
+    
+    for (const auto& cell : splits)
+    {
+        const uint32_t label = get_label(cell);
+        
+        if (label == none || label >= first_label)
+            continue;
+        
+        const uint32_t fresh = static_cast<uint32_t>(sizes.size());
+        sizes.push_back(0);
+        sizes[fresh] = flood(cell, fresh);
+    }
+    
+    splits.clear();
+}
+
+void connected_components::rebuild()
+{
+    size = walls.get_size();
+    labels.assign(static_cast<std::size_t>(size.x) * size.y, none);
+    stamps.assign(labels.size(), 0);
+    detour = 0;
+    sizes.clear();
+    splits.clear();
+    valid = true;
+    
+    for (int y = 0; y < size.y; ++y)
+        for (int x = 0; x < size.x; ++x)
+            if (labels[cell_index(x, y)] == none && !walls.is_blocked(x, y))
+            {
+                const uint32_t label = static_cast<uint32_t>(sizes.size());
+                sizes.push_back(0);
+                sizes[label] = flood({ x, y }, label);
+            }
+}
+
+uint32_t connected_components::flood(vector2_i _coordinates, uint32_t _label)
+{
+    const int directions = (diagonal ? 8 : 4);
+    uint32_t count = 1;
+    
+    labels[cell_index(_coordinates.x, _coordinates.y)] = _label;
+    stack.clear();
+    stack.push_back(cell_index(_coordinates.x, _coordinates.y));
+    
+    while (!stack.empty())
+    {
+        const uint32_t current = stack.back();
+        const int x = static_cast<int>(current % size.x);
+        const int y = static_cast<int>(current / size.x);
+        
+        stack.pop_back();
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = cell_index(nx, ny);
+            
+            if (labels[id] == _label)
+                continue;
+            
+            labels[id] = _label;
+            stack.push_back(id);
+            ++count;
+        }
+    }
+    
+    relabeled_cells += count;
+    
+    return count;
+}
+
+bool connected_components::is_ring_joined(vector2_i _coordinates) const
+{
+    // The 8 surrounding cells in circular order, straight moves at even indices
+    static const int ring_x[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    static const int ring_y[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    
+    bool free[8];
+    int group[8];
+    
+    for (int i = 0; i < 8; ++i)
+    {
+        free[i] = !walls.is_blocked(_coordinates.x + ring_x[i], _coordinates.y + ring_y[i]);
+        group[i] = i;
+    }
+    
+    auto find = [&group](int _index)
+    {
+        while (group[_index] != _index)
+            _index = group[_index];
+        
+        return _index;
+    };
+    
+    auto join = [&](int _first, int _second)
+    {
+        if (free[_first] && free[_second])
+            group[find(_first)] = find(_second);
+    };
+    
+    // Neighbors along the ring share a side
+    for (int i = 0; i < 8; ++i)
+        join(i, (i + 1) % 8);
+    
+    // Straight neighbors a corner apart are also a diagonal move apart
+    if (diagonal)
+        for (int i = 0; i < 8; i += 2)
+            join(i, (i + 2) % 8);
+    
+    // Only cells the blocked cell could move to matter
+    int root = -1;
+    
+    for (int i = 0; i < 8; i += (diagonal ? 1 : 2))
+    {
+        if (!free[i])
+            continue;
+        
+        if (root == -1)
+            root = find(i);
+        else if (find(i) != root)
+            return false;
+    }
+    
+    return true;
+}
+
+bool connected_components::find_detour(vector2_i _coordinates)
+{
+    const int directions = (diagonal ? 8 : 4);
+    std::size_t targets = 0;
+    
+    // Visited cells get the stamp, targets the stamp plus one
+    if (detour >= UINT32_MAX - 2)
+    {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        detour = 0;
+    }
+    
+    detour += 2;
+    
+    // Cells the blocked cell could move to, the first one starts the search
+    uint32_t first = none;
+    
+    for (int i = 0; i < directions; ++i)
+    {
+        const int nx = _coordinates.x + grid_direction_x[i];
+        const int ny = _coordinates.y + grid_direction_y[i];
+        
+        if (walls.is_blocked(nx, ny))
+            continue;
+        
+        if (first == none)
+            first = cell_index(nx, ny);
+        else
+        {
+            stamps[cell_index(nx, ny)] = detour + 1;
+            ++targets;
+        }
+    }
+    
+    if (targets == 0)
+        return true;
+    
+    // Breadth first, so that short detours are found within the limit
+    std::size_t visited = 0;
+    
+    stack.clear();
+    stack.push_back(first);
+    stamps[first] = detour;
+    
+    for (std::size_t next = 0; next < stack.size() && visited < detour_limit; ++next, ++visited)
+    {
+        const uint32_t current = stack[next];
+        const int x = static_cast<int>(current % size.x);
+        const int y = static_cast<int>(current / size.x);
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = cell_index(nx, ny);
+            
+            if (stamps[id] == detour)
+                continue;
+            
+            if (stamps[id] == detour + 1 && --targets == 0)
+                return true;
+            
+            stamps[id] = detour;
+            stack.push_back(id);
+        }
+    }
+    
+    return false;
+}
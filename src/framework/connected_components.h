@@ -0,0 +1,117 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Label of the connected region of free cells holding each cell.
+ * 
+ * Two cells share a label exactly when a path joins them, so a query 
+ * between different labels is rejected without searching.  Freeing a cell 
+ * joins the regions around it by relabeling all but the largest one.  
+ * Blocking a cell can only split its region when the free cells around it 
+ * are not joined among themselves, nor by a short detour found by a small 
+ * bounded search; those regions are flooded again on the next update.  Many changes at once fall back to labeling the whole world.
+ */
+class connected_components
+{
+    
+public:
+    
+    static const uint32_t none = UINT32_MAX;
+    
+    explicit connected_components(const occupancy_grid& _walls);
+    
+    // Labels the whole world on the next update
+    void invalidate_all();
+    
+    // Call after the cell changed in the occupancy grid
+    void block(vector2_i _coordinates);
+    void unblock(vector2_i _coordinates);
+    
+    // Applies pending changes, relabeling everything when the movement changed
+    void update(bool _diagonal);
+    
+    // Label of a free cell, none when blocked or outside.  Needs update().
+    inline uint32_t get_label(vector2_i _coordinates) const
+    {
+        if (!valid || _coordinates.x < 0 || _coordinates.y < 0 || _coordinates.x >= size.x || _coordinates.y >= size.y)
+            return none;
+        
+        return labels[cell_index(_coordinates.x, _coordinates.y)];
+    }
+    
+    // Whether a path joins the cells.  Needs update().
+    inline bool is_connected(vector2_i _start, vector2_i _goal) const
+    {
+        const uint32_t label = get_label(_start);
+        return (label != none && label == get_label(_goal));
+    }
+    
+    // Cells flooded by updates since the components were created
+    inline std::size_t get_relabeled_cells() const { return relabeled_cells; }
+    
+    inline std::size_t get_memory_usage() const { return labels.size() * sizeof(uint32_t); }
+    
+private:
+    
+    const occupancy_grid& walls;
+    vector2_i size;
+    bool diagonal;
+    bool valid;
+    
+    std::vector<uint32_t> labels;       // cell id -> label, none when blocked
+    std::vector<uint32_t> sizes;        // label -> cells, stale after splits
+    std::vector<uint32_t> stack;
+    std::vector<vector2_i> splits;      // cells whose region may have split
+    std::vector<uint32_t> stamps;       // cell id -> detour search that reached it
+    uint32_t detour;
+    std::size_t relabeled_cells;
+    
+    inline uint32_t cell_index(int _x, int _y) const
+    {
+        return static_cast<uint32_t>(_y * size.x + _x);
+    }
+    
+    void rebuild();
+    
+    // Gives _label to every free cell reachable from the cell that does not 
+    // have it yet, and returns how many cells changed
+    uint32_t flood(vector2_i _coordinates, uint32_t _label);
+    
+    // Whether the free cells around a newly blocked cell still reach each other
+    bool is_ring_joined(vector2_i _coordinates) const;
+    
+    // Same question answered by a search that gives up after a few cells
+    bool find_detour(vector2_i _coordinates);
+    
+};
+
+#endif /* CONNECTED_COMPONENTS_H */
@@ -0,0 +1,470 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "contraction_hierarchy.h"
+#include <algorithm>
+#include <assert.h>
+#include <framework/search_grid.h>
+
+namespace
+{
+    // Nodes a witness search may settle before it gives up and lets the 
+    // shortcut through.  Higher limits mean fewer shortcuts but slower 
+    // preprocessing.
+    const std::size_t witness_settle_limit = 256;
+}
+
+const uint32_t contraction_hierarchy::none;
+
+contraction_hierarchy::contraction_hierarchy(const occupancy_grid& _walls) :
+      walls(_walls)
+    , size({ 0, 0 })
+    , diagonal(false)
+    , built(false)
+    , shortcuts(0)
+    , query(0)
+    , expansions(0)
+    , witness_search(0)
+{}
+
+void contraction_hierarchy::invalidate()
+{
+    built = false;
+}
+
+void contraction_hierarchy::build(bool _diagonal)
+{
+    size = walls.get_size();
+    diagonal = _diagonal;
+    built = true;
+    
+    const int directions = (diagonal ? 8 : 4);
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+    
+    nodes.assign(count, none);
+    cells.clear();
+    
+    for (int y = 0; y < size.y; ++y)
+        for (int x = 0; x < size.x; ++x)
+            if (!walls.is_blocked(x, y))
+            {
+                nodes[static_cast<std::size_t>(y) * size.x + x] = static_cast<uint32_t>(cells.size());
+                cells.push_back({ x, y });
+            }
+    
+    const uint32_t node_count = static_cast<uint32_t>(cells.size());
+    
+    graph.assign(node_count, std::vector<edge>());
+    
+    for (uint32_t node = 0; node < node_count; ++node)
+    {
+        const vector2_i cell = cells[node];
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = cell.x + grid_direction_x[i];
+            const int ny = cell.y + grid_direction_y[i];
+            
+            if (!walls.is_blocked(nx, ny))
+                graph[node].push_back({ nodes[static_cast<std::size_t>(ny) * size.x + nx], (i < 4 ? 10 : 14), none });
+        }
+    }
+    
+    rank.assign(node_count, none);
+    removed_neighbors.assign(node_count, 0);
+    witness_distance.assign(node_count, 0);
+    witness_stamps.assign(node_count, 0);
+    witness_targets.assign(node_count, 0);
+    witness_open.reset(node_count);
+    witness_search = 0;
+    
+    // Contract the cheapest node first.  Priorities go stale as neighbors 
+    // are contracted, so the top is recomputed and pushed back down when it 
+    // got worse instead of updating every neighbor after each contraction.
+    indexed_heap<int32_t, 4> order;
+    order.reset(node_count);
+    
+    for (uint32_t node = 0; node < node_count; ++node)
+        order.push(node, contract(node, true), 0);
+    
+    uint32_t next_rank = 0;
+    
+    while (!order.empty())
+    {
+        const uint32_t node = order.top();
+        const int32_t priority = contract(node, true);
+        
+        if (priority > order.top_f())
+        {
+            order.update(node, priority, 0);
+            
+            if (order.top() != node)
+                continue;
+        }
+        
+        order.pop();
+        contract(node, false);
+        rank[node] = next_rank++;
+        
+        // The remaining edges of the node all lead upward and stay as they are
+        for (const auto& item : graph[node])
+        {
+            std::vector<edge>& back = graph[item.target];
+            
+            for (std::size_t i = 0; i < back.size(); ++i)
+                if (back[i].target == node)
+                {
+                    back[i] = back.back();
+                    back.pop_back();
+                    break;
+                }
+            
+            ++removed_neighbors[item.target];
+        }
+    }
+    
+    // Pack the upward edges with nodes numbered by rank
+    std::vector<uint32_t> by_rank(node_count);
+    std::vector<vector2_i> ranked_cells(node_count);
+    
+    for (uint32_t node = 0; node < node_count; ++node)
+    {
+        by_rank[rank[node]] = node;
+        ranked_cells[rank[node]] = cells[node];
+    }
+    
+    for (auto& node : nodes)
+        if (node != none)
+            node = rank[node];
+    
+    cells.swap(ranked_cells);
+    first_edge.assign(node_count + 1, 0);
+    upward.clear();
+    middles.clear();
+    shortcuts = 0;
+    
+    for (uint32_t node = 0; node < node_count; ++node)
+    {
+        first_edge[node] = static_cast<uint32_t>(upward.size());
+        
+        for (const auto& item : graph[by_rank[node]])
+        {
+            upward.push_back({ rank[item.target], item.cost });
+            middles.push_back(item.middle == none ? none : rank[item.middle]);
+            
+            if (item.middle != none)
+                ++shortcuts;
+        }
+    }
+    
+    first_edge[node_count] = static_cast<uint32_t>(upward.size());
+    
+    std::vector<std::vector<edge>>().swap(graph);
+    std::vector<uint32_t>().swap(rank);
+    std::vector<uint16_t>().swap(removed_neighbors);
+    std::vector<int32_t>().swap(witness_distance);
+    std::vector<uint32_t>().swap(witness_stamps);
+    std::vector<uint32_t>().swap(witness_targets);
+    witness_open.reset(0);
+    
+    for (side* item : { &forward, &backward })
+    {
+        item->distance.assign(node_count, 0);
+        item->parent.assign(node_count, none);
+        item->stamps.assign(node_count, 0);
+        item->open.reset(node_count);
+    }
+    
+    query = 0;
+}
+
+vector2_array_i contraction_hierarchy::find_path(vector2_i _start, vector2_i _goal, bool _diagonal)
+{
+    expansions = 0;
+    
+    if (!is_built(_diagonal))
+        build(_diagonal);
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    const uint32_t source = nodes[static_cast<std::size_t>(_start.y) * size.x + _start.x];
+    const uint32_t target = nodes[static_cast<std::size_t>(_goal.y) * size.x + _goal.x];
+    
+    if (source == target)
+        return { _goal };
+    
+    if (++query == 0)
+    {
+        std::fill(forward.stamps.begin(), forward.stamps.end(), 0);
+        std::fill(backward.stamps.begin(), backward.stamps.end(), 0);
+        query = 1;
+    }
+    
+    forward.open.clear();
+    backward.open.clear();
+    
+    forward.stamps[source] = query;
+    forward.distance[source] = 0;
+    forward.parent[source] = none;
+    forward.open.push(source, 0, 0);
+    
+    backward.stamps[target] = query;
+    backward.distance[target] = 0;
+    backward.parent[target] = none;
+    backward.open.push(target, 0, 0);
+    
+    // Both sides climb until neither can still improve the best meeting
+    int32_t best = INT32_MAX;
+    uint32_t meeting = none;
+    
+    for (;;)
+    {
+        const bool forward_open = (!forward.open.empty() && forward.open.top_f() < best);
+        const bool backward_open = (!backward.open.empty() && backward.open.top_f() < best);
+        
+        if (!forward_open && !backward_open)
+            break;
+        
+        if (forward_open && (!backward_open || forward.open.top_f() <= backward.open.top_f()))
+            settle(forward, backward, best, meeting);
+        else
+            settle(backward, forward, best, meeting);
+    }
+    
+    if (meeting == none)
+        return {};
+    
+    // Nodes from the goal up to the meeting node and down to the start
+    route.clear();
+    
+    for (uint32_t node = meeting; node != none; node = backward.parent[node])
+        route.push_back(node);
+    
+    std::reverse(route.begin(), route.end());
+    
+    for (uint32_t node = forward.parent[meeting]; node != none; node = forward.parent[node])
+        route.push_back(node);
+    
+    vector2_array_i path;
+    path.push_back(cells[route.front()]);
+    
+    for (std::size_t i = 1; i < route.size(); ++i)
+        unpack(route[i - 1], route[i], path);
+    
+    return path;
+}
+
+std::size_t contraction_hierarchy::get_memory_usage() const
+{
+    return nodes.size() * sizeof(uint32_t) 
+        + cells.size() * sizeof(vector2_i) 
+        + first_edge.size() * sizeof(uint32_t) 
+        + upward.size() * (sizeof(arc) + sizeof(uint32_t)) 
+        + 2 * forward.stamps.size() * (sizeof(int32_t) + 2 * sizeof(uint32_t));
+}
+
+int32_t contraction_hierarchy::contract(uint32_t _node, bool _simulate)
+{
+    const std::vector<edge>& neighbors = graph[_node];
+    int32_t added = 0;
+    
+    // Every pair of neighbors needs a shortcut unless a path avoiding the 
+    // node is at least as short.  Edges are undirected, so each pair is 
+    // checked from its first member only.
+    for (std::size_t i = 0; i + 1 < neighbors.size(); ++i)
+    {
+        const edge from = neighbors[i];
+        int32_t limit = 0;
+        
+        start_witness_search();
+        
+        for (std::size_t j = i + 1; j < neighbors.size(); ++j)
+        {
+            limit = std::max(limit, from.cost + neighbors[j].cost);
+            witness_targets[neighbors[j].target] = witness_search;
+        }
+        
+        find_witnesses(from.target, _node, limit, neighbors.size() - i - 1);
+        
+        for (std::size_t j = i + 1; j < neighbors.size(); ++j)
+        {
+            const edge to = neighbors[j];
+            const int32_t cost = from.cost + to.cost;
+            
+            if (witness_stamps[to.target] == witness_search && witness_distance[to.target] <= cost)
+                continue;
+            
+            ++added;
+            
+            if (!_simulate)
+            {
+                add_edge(from.target, to.target, cost, _node);
+                add_edge(to.target, from.target, cost, _node);
+            }
+        }
+    }
+    
+    // Edge difference, plus the neighbors already gone to spread contraction evenly
+    return 2 * (added - static_cast<int32_t>(neighbors.size())) + removed_neighbors[_node];
+}
+
+void contraction_hierarchy::start_witness_search()
+{
+    if (++witness_search == 0)
+    {
+        std::fill(witness_stamps.begin(), witness_stamps.end(), 0);
+        std::fill(witness_targets.begin(), witness_targets.end(), 0);
+        witness_search = 1;
+    }
+}
+
+void contraction_hierarchy::find_witnesses(uint32_t _source, uint32_t _skipped, int32_t _limit, std::size_t _targets)
+{
+    witness_open.clear();
+    witness_stamps[_source] = witness_search;
+    witness_distance[_source] = 0;
+    witness_open.push(_source, 0, 0);
+    
+    std::size_t settled = 0;
+    
+    while (!witness_open.empty() && witness_open.top_f() <= _limit && settled < witness_settle_limit)
+    {
+        const uint32_t current = witness_open.pop();
+        const int32_t distance = witness_distance[current];
+        
+        ++settled;
+        
+        // Settled neighbors of the skipped node have their final distance
+        if (witness_targets[current] == witness_search && --_targets == 0)
+            break;
+        
+        for (const auto& item : graph[current])
+        {
+            if (item.target == _skipped)
+                continue;
+            
+            const int32_t total_cost = distance + item.cost;
+            
+            if (total_cost > _limit)
+                continue;
+            
+            if (witness_stamps[item.target] != witness_search)
+            {
+                witness_stamps[item.target] = witness_search;
+                witness_distance[item.target] = total_cost;
+                witness_open.push(item.target, total_cost, 0);
+            }
+            else if (total_cost < witness_distance[item.target] && witness_open.contains(item.target))
+            {
+                witness_distance[item.target] = total_cost;
+                witness_open.decrease(item.target, total_cost, 0);
+            }
+        }
+    }
+}
+
+void contraction_hierarchy::add_edge(uint32_t _from, uint32_t _to, int32_t _cost, uint32_t _middle)
+{
+    for (auto& item : graph[_from])
+        if (item.target == _to)
+        {
+            if (_cost < item.cost)
+            {
+                item.cost = _cost;
+                item.middle = _middle;
+            }
+            
+            return;
+        }
+    
+    graph[_from].push_back({ _to, _cost, _middle });
+}
+
+bool contraction_hierarchy::settle(side& _side, const side& _other, int32_t& _best, uint32_t& _meeting)
+{
+    const uint32_t current = _side.open.pop();
+    const int32_t distance = _side.distance[current];
+    
+    ++expansions;
+    
+    if (_other.stamps[current] == query && distance + _other.distance[current] < _best)
+    {
+        _best = distance + _other.distance[current];
+        _meeting = current;
+    }
+    
+    const arc* first = upward.data() + first_edge[current];
+    const arc* last = upward.data() + first_edge[current + 1];
+    
+    // Stall-on-demand: a higher node reaching this one more cheaply means 
+    // this node is not on a shortest upward path, so its edges are skipped
+    for (const arc* item = first; item != last; ++item)
+        if (_side.stamps[item->target] == query && _side.distance[item->target] + item->cost < distance)
+            return false;
+    
+    for (const arc* item = first; item != last; ++item)
+    {
+        const int32_t total_cost = distance + item->cost;
+        
+        if (_side.stamps[item->target] != query)
+        {
+            _side.stamps[item->target] = query;
+            _side.distance[item->target] = total_cost;
+            _side.parent[item->target] = current;
+            _side.open.push(item->target, total_cost, 0);
+        }
+        else if (total_cost < _side.distance[item->target] && _side.open.contains(item->target))
+        {
+            _side.distance[item->target] = total_cost;
+            _side.parent[item->target] = current;
+            _side.open.decrease(item->target, total_cost, 0);
+        }
+    }
+    
+    return true;
+}
+
+void contraction_hierarchy::unpack(uint32_t _from, uint32_t _to, vector2_array_i& _path) const
+{
+    // Every edge is stored once, with its lower end
+    const uint32_t lower = std::min(_from, _to);
+    const uint32_t upper = std::max(_from, _to);
+    uint32_t index = first_edge[lower];
+    
+    while (upward[index].target != upper)
+        ++index;
+    
+    assert(index < first_edge[lower + 1]);
+    
+    const uint32_t middle = middles[index];
+    
+    if (middle == none)
+    {
+        _path.push_back(cells[_to]);
+        return;
+    }
+    
+    unpack(_from, middle, _path);
+    unpack(middle, _to, _path);
+}
@@ -0,0 +1,145 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Contraction hierarchy over the free cells of an occupancy grid.
+ * 
+ * Preprocessing removes cells one at a time, cheapest first by edge 
+ * difference, and adds a shortcut between two neighbors of the removed 
+ * cell whenever a bounded witness search finds no path as short as the 
+ * one through it.  Every cell gets the rank it was removed in.  Queries 
+ * then run Dijkstra from both ends over edges toward higher ranks only, 
+ * with stall-on-demand, and unpack the shortcuts of the meeting path back 
+ * into cells.  Nodes are numbered by rank after preprocessing, so the top 
+ * of the hierarchy that every query visits shares a few cache lines.
+ * 
+ * The hierarchy is built lazily on the first query and dropped when the 
+ * collisions, the world size or the movement change.  A build takes 
+ * seconds to minutes on worlds of a few hundred thousand cells.
+ */
+class contraction_hierarchy
+{
+    
+public:
+    
+    explicit contraction_hierarchy(const occupancy_grid& _walls);
+    
+    // Rebuilds the hierarchy on the next query
+    void invalidate();
+    
+    // Preprocesses the current collisions, done by find_path when needed
+    void build(bool _diagonal);
+    
+    // Whether queries with _diagonal movement run without a new build
+    inline bool is_built(bool _diagonal) const
+    {
+        return (built && diagonal == _diagonal && walls.get_size() == static_cast<vector2_i>(size));
+    }
+    
+    // Every cell of the path from _goal back to _start, empty if unreachable
+    vector2_array_i find_path(vector2_i _start, vector2_i _goal, bool _diagonal);
+    
+    // Cells settled by both sides of the last query
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    inline std::size_t get_node_count() const { return cells.size(); }
+    inline std::size_t get_shortcut_count() const { return shortcuts; }
+    
+    std::size_t get_memory_usage() const;
+    
+private:
+    
+    static const uint32_t none = UINT32_MAX;
+    
+    struct edge
+    {
+        uint32_t target;
+        int32_t cost;
+        uint32_t middle;    // node the shortcut skips, none for a move between cells
+    };
+    
+    // Upward edge of the query graph, kept to 8 bytes for the scans
+    struct arc
+    {
+        uint32_t target;
+        int32_t cost;
+    };
+    
+    // Search state of one side of a query, valid when stamped with the query
+    struct side
+    {
+        std::vector<int32_t> distance;
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> stamps;
+        indexed_heap<int32_t, 2> open;
+    };
+    
+    const occupancy_grid& walls;
+    vector2_i size;
+    bool diagonal;
+    bool built;
+    
+    std::vector<uint32_t> nodes;        // cell id -> node, none when blocked
+    std::vector<vector2_i> cells;       // node -> cell
+    std::vector<uint32_t> first_edge;   // node -> first upward edge, plus one past the end
+    std::vector<arc> upward;            // edges toward higher nodes
+    std::vector<uint32_t> middles;      // skipped node of each upward edge
+    std::size_t shortcuts;
+    
+    side forward;
+    side backward;
+    std::vector<uint32_t> route;        // meeting path from goal back to start
+    uint32_t query;
+    std::size_t expansions;
+    
+    // Preprocessing state
+    std::vector<std::vector<edge>> graph;
+    std::vector<uint32_t> rank;
+    std::vector<uint16_t> removed_neighbors;
+    std::vector<int32_t> witness_distance;
+    std::vector<uint32_t> witness_stamps;
+    std::vector<uint32_t> witness_targets;  // stamped when the search looks for the node
+    indexed_heap<int32_t, 4> witness_open;
+    uint32_t witness_search;
+    
+    int32_t contract(uint32_t _node, bool _simulate);
+    void start_witness_search();
+    void find_witnesses(uint32_t _source, uint32_t _skipped, int32_t _limit, std::size_t _targets);
+    void add_edge(uint32_t _from, uint32_t _to, int32_t _cost, uint32_t _middle);
+    
+    bool settle(side& _side, const side& _other, int32_t& _best, uint32_t& _meeting);
+    void unpack(uint32_t _from, uint32_t _to, vector2_array_i& _path) const;
+    
+};
+
+#endif /* CONTRACTION_HIERARCHY_H */
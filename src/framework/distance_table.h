@@ -0,0 +1,109 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DISTANCE_TABLE_H
+#define DISTANCE_TABLE_H
+
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Precomputed euclidean heuristic for every cell offset of a world.
+ * 
+ * Only offsets with dx >= dy are stored, in 16 bits each, so a 1024 x 1024 
+ * world takes 1 MB.  Worlds wider than 4634 cells would overflow 16 bits and 
+ * leave the table empty, in which case callers compute the distance.
+ */
+class distance_table
+{
+    
+public:
+    
+    static const int max_extent = 4634;
+    
+    explicit distance_table() : extent(0) {}
+    
+    // The euclidean heuristic of path_builder for an offset of (_dx, _dy)
+    inline static int compute(int _dx, int _dy)
+    {
+        return static_cast<int>(10 * std::sqrt(static_cast<double>(_dx * _dx + _dy * _dy)));
+    }
+    
+    // Covers every offset inside a world of _size, keeping a larger table
+    void resize(vector2_i _size)
+    {
+        const int needed = std::max(_size.x, _size.y);
+        
+        if (needed <= extent)
+            return;
+        
+        if (needed > max_extent)
+        {
+            values.clear();
+            extent = 0;
+            return;
+        }
+        
+        values.resize(static_cast<std::size_t>(needed) * (needed + 1) / 2);
+        
+        for (int dx = 0; dx < needed; ++dx)
+            for (int dy = 0; dy <= dx; ++dy)
+                values[offset(dx, dy)] = static_cast<uint16_t>(compute(dx, dy));
+        
+        extent = needed;
+    }
+    
+    inline bool covers(vector2_i _size) const 
+    { 
+        return (_size.x <= extent && _size.y <= extent); 
+    }
+    
+    // Distance for absolute offsets inside the covered extent
+    inline int get(int _dx, int _dy) const
+    {
+        if (_dx < _dy)
+            std::swap(_dx, _dy);
+        
+        return values[offset(_dx, _dy)];
+    }
+    
+    inline std::size_t get_memory_usage() const { return values.size() * sizeof(uint16_t); }
+    
+private:
+    
+    std::vector<uint16_t> values;
+    int extent;
+    
+    inline static std::size_t offset(int _dx, int _dy)
+    {
+        return static_cast<std::size_t>(_dx) * (_dx + 1) / 2 + _dy;
+    }
+    
+};
+
+#endif /* DISTANCE_TABLE_H */
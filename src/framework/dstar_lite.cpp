@@ -0,0 +1,287 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "dstar_lite.h"
+#include <algorithm>
+#include <framework/search_grid.h>
+
+const int32_t dstar_lite::infinity;
+
+dstar_lite::dstar_lite(const occupancy_grid& _walls) :
+      walls(_walls)
+    , expansions(0)
+    , size({ 0, 0 })
+    , start({ 0, 0 })
+    , goal({ 0, 0 })
+    , directions(4)
+    , key_modifier(0)
+    , initialized(false)
+{}
+
+void dstar_lite::invalidate_all()
+{
+    initialized = false;
+    changed.clear();
+}
+
+void dstar_lite::invalidate(vector2_i _coordinates)
+{
+    if (initialized)
+        changed.push_back(cell_index(_coordinates.x, _coordinates.y));
+}
+
+vector2_array_i dstar_lite::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    expansions = 0;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    if (_start == static_cast<vector2_i>(_goal))
+        return { _start };
+    
+    const vector2_i world = walls.get_size();
+    const std::size_t count = static_cast<std::size_t>(world.x) * world.y;
+    
+    // A large batch of edits is cheaper to solve from scratch
+    if (!initialized 
+        || world != static_cast<vector2_i>(size) 
+        || _goal != static_cast<vector2_i>(goal) 
+        || directions != (_diagonal ? 8 : 4)
+        || changed.size() > count / 8)
+    {
+        start = _start;
+        heuristic = _heuristic;
+        initialize(_goal, _diagonal);
+    }
+    else
+    {
+        // Keys already queued stay valid lower bounds once km grows by the move
+        key_modifier += heuristic(start, _start);
+        start = _start;
+        
+        for (uint32_t id : changed)
+        {
+            const int x = static_cast<int>(id % size.x);
+            const int y = static_cast<int>(id / size.x);
+            
+            update_vertex(x, y);
+            
+            for (int i = 0; i < directions; ++i)
+                update_vertex(x + grid_direction_x[i], y + grid_direction_y[i]);
+        }
+    }
+    
+    changed.clear();
+    compute_shortest_path();
+    
+    if (rhs[cell_index(start.x, start.y)] >= infinity)
+        return {};
+    
+    // Walk downhill on g from the start, then hand back goal first
+    vector2_array_i path;
+    int x = start.x;
+    int y = start.y;
+    
+    path.push_back({ x, y });
+    
+    while ((x != goal.x || y != goal.y) && path.size() <= count)
+    {
+        int32_t best = infinity;
+        int next = -1;
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const int32_t cost = add_cost(g[cell_index(nx, ny)], (i < 4 ? 10 : 14));
+            
+            if (cost < best)
+            {
+                best = cost;
+                next = i;
+            }
+        }
+        
+        if (next < 0)
+            return {};
+        
+        x += grid_direction_x[next];
+        y += grid_direction_y[next];
+        path.push_back({ x, y });
+    }
+    
+    std::reverse(path.begin(), path.end());
+    
+    return path;
+}
+
+void dstar_lite::initialize(vector2_i _goal, bool _diagonal)
+{
+    size = walls.get_size();
+    goal = _goal;
+    directions = (_diagonal ? 8 : 4);
+    key_modifier = 0;
+    
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+    
+    g.assign(count, infinity);
+    rhs.assign(count, infinity);
+    open.reset(count);
+    
+    const uint32_t id = cell_index(goal.x, goal.y);
+    rhs[id] = 0;
+    open.push(id, heuristic(start, goal), 0);
+    
+    initialized = true;
+}
+
+// Cheapest cost to the goal through a neighbor, from the current g values
+int32_t dstar_lite::lookahead(int _x, int _y) const
+{
+    if (walls.is_blocked(_x, _y))
+        return infinity;
+    
+    int32_t best = infinity;
+    
+    for (int i = 0; i < directions; ++i)
+    {
+        const int nx = _x + grid_direction_x[i];
+        const int ny = _y + grid_direction_y[i];
+        
+        if (walls.is_blocked(nx, ny))
+            continue;
+        
+        best = std::min(best, add_cost(g[cell_index(nx, ny)], (i < 4 ? 10 : 14)));
+    }
+    
+    return best;
+}
+
+void dstar_lite::update_vertex(int _x, int _y)
+{
+    if (_x < 0 || _y < 0 || _x >= size.x || _y >= size.y)
+        return;
+    
+    const uint32_t id = cell_index(_x, _y);
+    
+    if (_x != goal.x || _y != goal.y)
+        rhs[id] = lookahead(_x, _y);
+    
+    update_key(id, _x, _y);
+}
+
+// Queues a locally inconsistent cell under its current key
+void dstar_lite::update_key(uint32_t _id, int _x, int _y)
+{
+    if (g[_id] != rhs[_id])
+    {
+        const int32_t k2 = std::min(g[_id], rhs[_id]);
+        const int32_t k1 = add_cost(k2, heuristic(start, { _x, _y }) + key_modifier);
+        
+        if (open.contains(_id))
+            open.update(_id, k1, -k2);
+        else
+            open.push(_id, k1, -k2);
+    }
+    else if (open.contains(_id))
+    {
+        open.remove(_id);
+    }
+}
+
+void dstar_lite::compute_shortest_path()
+{
+    const uint32_t start_id = cell_index(start.x, start.y);
+    
+    while (!open.empty())
+    {
+        const int32_t start_k2 = std::min(g[start_id], rhs[start_id]);
+        const int32_t start_k1 = add_cost(start_k2, key_modifier);
+        const int32_t top_k1 = open.top_f();
+        const int32_t top_k2 = -open.top_g();
+        
+        // Done once the start is consistent and nothing queued can improve it
+        if ((top_k1 > start_k1 || (top_k1 == start_k1 && top_k2 >= start_k2)) 
+            && g[start_id] == rhs[start_id])
+            break;
+        
+        const uint32_t id = open.top();
+        const int x = static_cast<int>(id % size.x);
+        const int y = static_cast<int>(id / size.x);
+        const int32_t k2 = std::min(g[id], rhs[id]);
+        const int32_t k1 = add_cost(k2, heuristic(start, { x, y }) + key_modifier);
+        
+        // Stale key from before the start moved
+        if (top_k1 < k1 || (top_k1 == k1 && top_k2 < k2))
+        {
+            open.update(id, k1, -k2);
+            continue;
+        }
+        
+        open.pop();
+        ++expansions;
+        
+        const int32_t old_g = g[id];
+        
+        // Overconsistent cells lower their neighbors, underconsistent cells 
+        // make the neighbors that relied on them look for a new successor
+        if (old_g > rhs[id])
+            g[id] = rhs[id];
+        else
+            g[id] = infinity;
+        
+        if (!walls.is_blocked(x, y))
+        {
+            for (int i = 0; i < directions; ++i)
+            {
+                const int nx = x + grid_direction_x[i];
+                const int ny = y + grid_direction_y[i];
+                
+                if (walls.is_blocked(nx, ny) || (nx == goal.x && ny == goal.y))
+                    continue;
+                
+                const uint32_t neighbor = cell_index(nx, ny);
+                const int32_t cost = (i < 4 ? 10 : 14);
+                
+                if (g[id] < infinity)
+                    rhs[neighbor] = std::min(rhs[neighbor], g[id] + cost);
+                else if (rhs[neighbor] == add_cost(old_g, cost))
+                    rhs[neighbor] = lookahead(nx, ny);
+                
+                update_key(neighbor, nx, ny);
+            }
+        }
+        
+        if (g[id] >= infinity)
+            update_vertex(x, y);
+    }
+}
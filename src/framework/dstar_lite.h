@@ -0,0 +1,108 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DSTAR_LITE_H
+#define DSTAR_LITE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * D* Lite incremental planner over an occupancy grid.
+ * 
+ * The search runs backward from the goal and keeps its g and rhs values 
+ * between queries.  Changed cells only requeue themselves and their 
+ * neighbors, so a replan after a small edit repairs the costs around the 
+ * edit instead of searching the whole map again.  The start may move 
+ * between queries.  A new goal, world size or connectivity starts over.
+ */
+class dstar_lite
+{
+    
+public:
+    
+    explicit dstar_lite(const occupancy_grid& _walls);
+    
+    // Drops the search state, needed when the heuristic changes
+    void invalidate_all();
+    
+    // Queues a cell whose collision changed for the next query
+    void invalidate(vector2_i _coordinates);
+    
+    // Every cell of the path from _goal back to _start, empty if unreachable
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    // Cells expanded by the last call to find_path
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    inline std::size_t get_memory_usage() const 
+    { 
+        return g.size() * (2 * sizeof(int32_t) + sizeof(uint32_t)); 
+    }
+    
+private:
+    
+    static const int32_t infinity = INT32_MAX / 2;
+    
+    const occupancy_grid& walls;
+    std::vector<int32_t> g;
+    std::vector<int32_t> rhs;
+    indexed_heap<int32_t, 2> open;      // second key is stored negated
+    std::vector<uint32_t> changed;
+    std::function<int(vector2_i, vector2_i)> heuristic;
+    std::size_t expansions;
+    vector2_i size;
+    vector2_i start;
+    vector2_i goal;
+    int directions;
+    int32_t key_modifier;
+    bool initialized;
+    
+    inline uint32_t cell_index(int _x, int _y) const 
+    { 
+        return static_cast<uint32_t>(_y * size.x + _x); 
+    }
+    
+    inline static int32_t add_cost(int32_t _g, int32_t _cost)
+    {
+        return (_g >= infinity ? infinity : _g + _cost);
+    }
+    
+    void initialize(vector2_i _goal, bool _diagonal);
+    int32_t lookahead(int _x, int _y) const;
+    void update_vertex(int _x, int _y);
+    void update_key(uint32_t _id, int _x, int _y);
+    void compute_shortest_path();
+    
+};
+
+#endif /* DSTAR_LITE_H */
@@ -0,0 +1,159 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "flow_field.h"
+#include <algorithm>
+#include <framework/search_grid.h>
+
+const int32_t flow_field::unreachable;
+const uint8_t flow_field::no_step;
+
+flow_field::flow_field(const occupancy_grid& _walls) :
+      walls(_walls)
+    , expansions(0)
+    , rebuilds(0)
+    , size({ 0, 0 })
+    , goal({ 0, 0 })
+    , directions(4)
+    , valid(false)
+{}
+
+void flow_field::invalidate()
+{
+    valid = false;
+}
+
+void flow_field::update(vector2_i _goal, bool _diagonal)
+{
+    expansions = 0;
+    
+    if (valid 
+        && _goal == static_cast<vector2_i>(goal) 
+        && directions == (_diagonal ? 8 : 4)
+        && walls.get_size() == static_cast<vector2_i>(size))
+        return;
+    
+    goal = _goal;
+    directions = (_diagonal ? 8 : 4);
+    rebuild();
+}
+
+vector2_i flow_field::get_next_step(vector2_i _coordinates) const
+{
+    if (!valid || _coordinates.x < 0 || _coordinates.y < 0 || _coordinates.x >= size.x || _coordinates.y >= size.y)
+        return _coordinates;
+    
+    const uint8_t next = step[cell_index(_coordinates.x, _coordinates.y)];
+    
+    if (next == no_step)
+        return _coordinates;
+    
+    return { _coordinates.x - grid_direction_x[next], _coordinates.y - grid_direction_y[next] };
+}
+
+int32_t flow_field::get_distance(vector2_i _coordinates) const
+{
+    if (!valid || _coordinates.x < 0 || _coordinates.y < 0 || _coordinates.x >= size.x || _coordinates.y >= size.y)
+        return unreachable;
+    
+    return distance[cell_index(_coordinates.x, _coordinates.y)];
+}
+
+vector2_array_i flow_field::find_path(vector2_i _start, vector2_i _goal, bool _diagonal)
+{
+    update(_goal, _diagonal);
+    
+    if (get_distance(_start) == unreachable)
+        return {};
+    
+    // Walk the field from the start, then hand back goal first
+    vector2_array_i path;
+    vector2_i position = _start;
+    
+    path.push_back(position);
+    
+    while (position != static_cast<vector2_i>(goal))
+    {
+        position = get_next_step(position);
+        path.push_back(position);
+    }
+    
+    std::reverse(path.begin(), path.end());
+    
+    return path;
+}
+
+void flow_field::rebuild()
+{
+    size = walls.get_size();
+    
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+    
+    distance.assign(count, unreachable);
+    step.assign(count, no_step);
+    open.reset(count);
+    
+    valid = true;
+    ++rebuilds;
+    
+    if (walls.is_blocked(goal))
+        return;
+    
+    const uint32_t first = cell_index(goal.x, goal.y);
+    distance[first] = 0;
+    open.push(first, 0, 0);
+    
+    // Moves cost the same both ways, so distances from the goal are distances to it
+    while (!open.empty())
+    {
+        const uint32_t current = open.pop();
+        const int x = static_cast<int>(current % size.x);
+        const int y = static_cast<int>(current / size.x);
+        const int32_t g = distance[current];
+        
+        ++expansions;
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint32_t id = cell_index(nx, ny);
+            const int32_t total_cost = g + (i < 4 ? 10 : 14);
+            
+            if (total_cost >= distance[id])
+                continue;
+            
+            if (distance[id] == unreachable)
+                open.push(id, total_cost, 0);
+            else
+                open.decrease(id, total_cost, 0);
+            
+            distance[id] = total_cost;
+            step[id] = static_cast<uint8_t>(i);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Distance and next-step field toward one goal.
+ * 
+ * A Dijkstra search from the goal stores the cost to the goal and the 
+ * direction of the next move for every reachable cell.  Any number of 
+ * agents heading to that goal then read their next cell in O(1).  The 
+ * field is rebuilt lazily, on the first use after the goal, the movement 
+ * or the collisions change.
+ */
+class flow_field
+{
+    
+public:
+    
+    static const int32_t unreachable = INT32_MAX;
+    
+    explicit flow_field(const occupancy_grid& _walls);
+    
+    // Rebuilds the field on the next update
+    void invalidate();
+    
+    // Makes the field point to _goal, rebuilding it only when it is stale
+    void update(vector2_i _goal, bool _diagonal);
+    
+    // Cell to move to from _coordinates, or _coordinates itself at the goal 
+    // and on cells that cannot reach it
+    vector2_i get_next_step(vector2_i _coordinates) const;
+    
+    // Cost to the goal in 10/14 units, or unreachable
+    int32_t get_distance(vector2_i _coordinates) const;
+    
+    // Cost to the goal of every cell in row-major order
+    inline const std::vector<int32_t>& get_distances() const { return distance; }
+    
+    // Every cell of the path from _goal back to _start, empty if unreachable
+    vector2_array_i find_path(vector2_i _start, vector2_i _goal, bool _diagonal);
+    
+    // Cells settled by the last rebuild, 0 when the field was reused
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    inline std::size_t get_rebuilds() const { return rebuilds; }
+    
+    inline std::size_t get_memory_usage() const 
+    { 
+        return distance.size() * (sizeof(int32_t) + sizeof(uint8_t)); 
+    }
+    
+private:
+    
+    static const uint8_t no_step = 0xF;
+    
+    const occupancy_grid& walls;
+    std::vector<int32_t> distance;
+    std::vector<uint8_t> step;      // index into the direction table toward the goal
+    indexed_heap<int32_t, 4> open;
+    std::size_t expansions;
+    std::size_t rebuilds;
+    vector2_i size;
+    vector2_i goal;
+    int directions;
+    bool valid;
+    
+    inline uint32_t cell_index(int _x, int _y) const 
+    { 
+        return static_cast<uint32_t>(_y * size.x + _x); 
+    }
+    
+    void rebuild();
+    
+};
+
+#endif /* FLOW_FIELD_H */
@@ -0,0 +1,191 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "fringe_search.h"
+#include <algorithm>
+#include <climits>
+
+fringe_search::fringe_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , expansions(0)
+    , sweeps(0)
+{}
+
+void fringe_search::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , heuristic_type _type
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic
+    , const distance_table& _euclidean
+    , vector2_array_i& _path)
+{
+    _path.clear();
+    expansions = 0;
+    sweeps = 0;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return;
+    
+    switch (_type)
+    {
+        case heuristic_type::MANHATTAN:
+            return search(_start, _goal, _diagonal, manhattan_policy(), _path);
+        case heuristic_type::OCTAGONAL:
+            return search(_start, _goal, _diagonal, octagonal_policy(), _path);
+        case heuristic_type::EUCLIDEAN:
+            if (_euclidean.covers(walls.get_size()))
+                return search(_start, _goal, _diagonal, euclidean_table_policy{ _euclidean }, _path);
+            
+            return search(_start, _goal, _diagonal, euclidean_policy(), _path);
+        case heuristic_type::LANDMARK:
+            if (const landmark_heuristic* landmarks = _heuristic.target<landmark_heuristic>())
+                return search(_start, _goal, _diagonal, *landmarks, _path);
+            
+            return search(_start, _goal, _diagonal, function_policy{ _heuristic }, _path);
+        default:
+            return search(_start, _goal, _diagonal, function_policy{ _heuristic }, _path);
+    }
+}
+
+template<class heuristic_policy>
+void fringe_search::search(vector2_i _start, vector2_i _goal, bool _diagonal, const heuristic_policy& _heuristic, vector2_array_i& _path)
+{
+    if (_diagonal)
+        search<eight_neighbors>(_start, _goal, _heuristic, _path);
+    else
+        search<four_neighbors>(_start, _goal, _heuristic, _path);
+}
+
+template<class neighborhood, class heuristic_policy>
+void fringe_search::search(vector2_i _start, vector2_i _goal, const heuristic_policy& _heuristic, vector2_array_i& _path)
+{
+    const int width = walls.get_size().x;
+    const std::size_t count = static_cast<std::size_t>(width) * walls.get_size().y;
+    const uint32_t head = static_cast<uint32_t>(count);
+    
+    cells.resize(count);
+    cells.reset();
+    
+    if (h.size() != count)
+    {
+        h.assign(count, 0);
+        next.assign(count + 1, head);
+        previous.assign(count + 1, head);
+    }
+    
+    next[head] = head;
+    previous[head] = head;
+    
+    int32_t offsets[8];
+    
+    for (int i = 0; i < 8; ++i)
+        offsets[i] = grid_direction_y[i] * width + grid_direction_x[i];
+    
+    const uint32_t start = static_cast<uint32_t>(_start.y * width + _start.x);
+    const uint32_t goal = static_cast<uint32_t>(_goal.y * width + _goal.x);
+    
+    h[start] = _heuristic(_start, _goal);
+    cells.open(start, 0, search_grid::no_parent);
+    link_after(head, start);
+    
+    int32_t threshold = h[start];
+    
+    while (next[head] != head)
+    {
+        int32_t next_threshold = INT32_MAX;
+        uint32_t current = next[head];
+        
+        ++sweeps;
+        
+        while (current != head)
+        {
+            const int32_t g = cells.get_g(current);
+            const int32_t f = g + h[current];
+            
+            // Later: waits for a higher threshold
+            if (f > threshold)
+            {
+                next_threshold = std::min(next_threshold, f);
+                current = next[current];
+                continue;
+            }
+            
+            if (current == goal)
+            {
+                int x = _goal.x;
+                int y = _goal.y;
+                
+                for (;;)
+                {
+                    _path.push_back({ x, y });
+                    
+                    uint8_t parent = cells.get_parent(static_cast<uint32_t>(y * width + x));
+                    
+                    if (parent == search_grid::no_parent)
+                        return;
+                    
+                    x -= grid_direction_x[parent];
+                    y -= grid_direction_y[parent];
+                }
+            }
+            
+            ++expansions;
+            
+            const int x = static_cast<int>(current) % width;
+            const int y = static_cast<int>(current) / width;
+            const uint32_t blocked = blocked_neighbors(walls, x, y);
+            
+            alignas(16) int32_t scores[8];
+            score_neighbors<neighborhood>(_heuristic, x, y, _goal, scores);
+            
+            // Now: children go right behind the cell, in the current sweep
+            for (int i = neighborhood::count - 1; i >= 0; --i)
+            {
+                if (blocked & (1u << i))
+                    continue;
+                
+                const uint32_t id = static_cast<uint32_t>(static_cast<int32_t>(current) + offsets[i]);
+                const int32_t total_cost = g + (i < 4 ? 10 : 14);
+                const node_state state = cells.get_state(id);
+                
+                if (state == node_state::NONE)
+                    h[id] = scores[i];
+                else if (total_cost >= cells.get_g(id))
+                    continue;
+                else if (state == node_state::IN_OPEN_LIST)
+                    unlink(id);
+                
+                cells.open(id, total_cost, static_cast<uint8_t>(i));
+                link_after(current, id);
+            }
+            
+            const uint32_t following = next[current];
+            unlink(current);
+            cells.close(current);
+            current = following;
+        }
+        
+        threshold = next_threshold;
+    }
+}
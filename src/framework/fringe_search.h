@@ -0,0 +1,104 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FRINGE_SEARCH_H
+#define FRINGE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <framework/distance_table.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <framework/search_kernel.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Fringe Search over an occupancy grid.
+ * 
+ * Keeps the open cells in one linked list instead of a priority queue and 
+ * sweeps it once per f threshold.  The sweep expands every cell with f 
+ * under the threshold and links its children right behind it, so they are 
+ * visited in the same sweep, while cells over the threshold stay in the list 
+ * for the next one, whose threshold is the smallest f they had.  Like IDA*
+ * the threshold only rises to the next f that exists, so the path is 
+ * optimal, but cells are never searched twice for one threshold.
+ */
+class fringe_search
+{
+    
+public:
+    
+    explicit fringe_search(const occupancy_grid& _walls);
+    
+    // Fills _path from _goal back to _start, keeping its capacity, and 
+    // empties it if the goal is unreachable
+    void find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , heuristic_type _type
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic
+        , const distance_table& _euclidean
+        , vector2_array_i& _path);
+    
+    // Cells expanded by the last call to find_path
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    // Sweeps over the list, one per threshold, in the last call to find_path
+    inline std::size_t get_sweeps() const { return sweeps; }
+    
+private:
+    
+    const occupancy_grid& walls;
+    search_grid cells;              // the list holds the open cells, closed cells keep their g
+    std::vector<int32_t> h;
+    std::vector<uint32_t> next;     // list links by cell id, the last entry is the head
+    std::vector<uint32_t> previous;
+    std::size_t expansions;
+    std::size_t sweeps;
+    
+    template<class neighborhood, class heuristic_policy>
+    void search(vector2_i _start, vector2_i _goal, const heuristic_policy& _heuristic, vector2_array_i& _path);
+    
+    template<class heuristic_policy>
+    void search(vector2_i _start, vector2_i _goal, bool _diagonal, const heuristic_policy& _heuristic, vector2_array_i& _path);
+    
+    inline void link_after(uint32_t _position, uint32_t _id)
+    {
+        next[_id] = next[_position];
+        previous[_id] = _position;
+        previous[next[_position]] = _id;
+        next[_position] = _id;
+    }
+    
+    inline void unlink(uint32_t _id)
+    {
+        next[previous[_id]] = next[_id];
+        previous[next[_id]] = previous[_id];
+    }
+    
+};
+
+#endif /* FRINGE_SEARCH_H */
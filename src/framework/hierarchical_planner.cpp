@@ -0,0 +1,652 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hierarchical_planner.h"
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    // Runs of free border cells at least this wide get an entrance at each end
+    const int wide_entrance = 6;
+}
+
+const uint32_t hierarchical_planner::none;
+
+hierarchical_planner::hierarchical_planner(const occupancy_grid& _walls, int _cluster_size) :
+      walls(_walls)
+    , cluster_size(std::max(_cluster_size, 2))
+    , clusters_x(0)
+    , clusters_y(0)
+    , built_size({ 0, 0 })
+    , diagonal(false)
+    , built(false)
+    , expansions(0)
+    , rebuilt_clusters(0)
+    , cost(-1)
+    , bound(std::numeric_limits<double>::infinity())
+    , local_origin({ 0, 0 })
+    , local_extent({ 0, 0 })
+{}
+
+void hierarchical_planner::set_cluster_size(int _cluster_size)
+{
+    cluster_size = std::max(_cluster_size, 2);
+    built = false;
+}
+
+void hierarchical_planner::invalidate_all()
+{
+    built = false;
+}
+
+void hierarchical_planner::invalidate(vector2_i _coordinates)
+{
+    if (!built || walls.get_size() != static_cast<vector2_i>(built_size) || !walls.is_inside(_coordinates))
+        return;
+    
+    const int cx = _coordinates.x / cluster_size;
+    const int cy = _coordinates.y / cluster_size;
+    const int lx = _coordinates.x - cx * cluster_size;
+    const int ly = _coordinates.y - cy * cluster_size;
+    const uint32_t cluster = static_cast<uint32_t>(cy * clusters_x + cx);
+    
+    mark_dirty(cx, cy);
+    
+    // Border cells also shape the entrances of the neighbor
+    if (lx == cluster_size - 1 && cx + 1 < clusters_x)
+    {
+        east_borders[cluster].dirty = true;
+        mark_dirty(cx + 1, cy);
+    }
+    
+    if (lx == 0 && cx > 0)
+    {
+        east_borders[cluster - 1].dirty = true;
+        mark_dirty(cx - 1, cy);
+    }
+    
+    if (ly == cluster_size - 1 && cy + 1 < clusters_y)
+    {
+        north_borders[cluster].dirty = true;
+        mark_dirty(cx, cy + 1);
+    }
+    
+    if (ly == 0 && cy > 0)
+    {
+        north_borders[cluster - clusters_x].dirty = true;
+        mark_dirty(cx, cy - 1);
+    }
+}
+
+void hierarchical_planner::mark_dirty(int _cluster_x, int _cluster_y)
+{
+    const uint32_t cluster = static_cast<uint32_t>(_cluster_y * clusters_x + _cluster_x);
+    
+    if (!dirty[cluster])
+    {
+        dirty[cluster] = 1;
+        dirty_clusters.push_back(cluster);
+    }
+}
+
+std::size_t hierarchical_planner::get_node_count() const
+{
+    return nodes.size() - free_nodes.size();
+}
+
+void hierarchical_planner::update()
+{
+    if (!built || walls.get_size() != static_cast<vector2_i>(built_size))
+    {
+        rebuild();
+        return;
+    }
+    
+    // Entrances first, the edges of both sides depend on them
+    for (auto cluster : dirty_clusters)
+    {
+        const int cx = static_cast<int>(cluster) % clusters_x;
+        const int cy = static_cast<int>(cluster) / clusters_x;
+        
+        if (east_borders[cluster].dirty) build_border(cx, cy, true);
+        if (north_borders[cluster].dirty) build_border(cx, cy, false);
+    }
+    
+    for (auto cluster : dirty_clusters)
+    {
+        build_edges(cluster);
+        dirty[cluster] = 0;
+    }
+    
+    rebuilt_clusters += dirty_clusters.size();
+    dirty_clusters.clear();
+}
+
+void hierarchical_planner::rebuild()
+{
+    built_size = walls.get_size();
+    clusters_x = (built_size.x + cluster_size - 1) / cluster_size;
+    clusters_y = (built_size.y + cluster_size - 1) / cluster_size;
+    
+    const std::size_t count = static_cast<std::size_t>(clusters_x) * clusters_y;
+    
+    nodes.clear();
+    free_nodes.clear();
+    east_borders.assign(count, border());
+    north_borders.assign(count, border());
+    dirty.assign(count, 0);
+    dirty_clusters.clear();
+    
+    for (int cy = 0; cy < clusters_y; ++cy)
+    {
+        for (int cx = 0; cx < clusters_x; ++cx)
+        {
+            build_border(cx, cy, true);
+            build_border(cx, cy, false);
+        }
+    }
+    
+    for (uint32_t cluster = 0; cluster < count; ++cluster)
+        build_edges(cluster);
+    
+    rebuilt_clusters += count;
+    built = true;
+}
+
+void hierarchical_planner::release_border(border& _border)
+{
+    for (auto list : { &_border.near_nodes, &_border.far_nodes })
+    {
+        for (auto id : *list)
+        {
+            nodes[id].alive = false;
+            nodes[id].edges.clear();
+            free_nodes.push_back(id);
+        }
+        
+        list->clear();
+    }
+    
+    _border.dirty = false;
+}
+
+uint32_t hierarchical_planner::create_node(vector2_i _position, uint32_t _cluster)
+{
+    uint32_t id;
+    
+    if (!free_nodes.empty())
+    {
+        id = free_nodes.back();
+        free_nodes.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(abstract_node());
+    }
+    
+    nodes[id].position = _position;
+    nodes[id].cluster = _cluster;
+    nodes[id].partner = none;
+    nodes[id].alive = true;
+    nodes[id].edges.clear();
+    
+    return id;
+}
+
+void hierarchical_planner::build_border(int _cluster_x, int _cluster_y, bool _east)
+{
+    const uint32_t cluster = static_cast<uint32_t>(_cluster_y * clusters_x + _cluster_x);
+    border& current = (_east ? east_borders[cluster] : north_borders[cluster]);
+    
+    release_border(current);
+    
+    if ((_east && _cluster_x + 1 >= clusters_x) || (!_east && _cluster_y + 1 >= clusters_y))
+        return;
+    
+    const uint32_t neighbor = (_east ? cluster + 1 : cluster + clusters_x);
+    
+    // The near side is the last column (east) or row (north) of the cluster
+    const vector2_i step = (_east ? vector2_i({ 0, 1 }) : vector2_i({ 1, 0 }));
+    const vector2_i across = (_east ? vector2_i({ 1, 0 }) : vector2_i({ 0, 1 }));
+    const vector2_i first = (_east 
+        ? vector2_i({ (_cluster_x + 1) * cluster_size - 1, _cluster_y * cluster_size })
+        : vector2_i({ _cluster_x * cluster_size, (_cluster_y + 1) * cluster_size - 1 }));
+    const int length = (_east 
+        ? std::min(cluster_size, built_size.y - first.y) 
+        : std::min(cluster_size, built_size.x - first.x));
+    
+    auto add_entrance = [&](int _offset)
+    {
+        vector2_i near_cell({ first.x + step.x * _offset, first.y + step.y * _offset });
+        vector2_i far_cell({ near_cell.x + across.x, near_cell.y + across.y });
+        
+        uint32_t near_id = create_node(near_cell, cluster);
+        uint32_t far_id = create_node(far_cell, neighbor);
+        
+        nodes[near_id].partner = far_id;
+        nodes[far_id].partner = near_id;
+        current.near_nodes.push_back(near_id);
+        current.far_nodes.push_back(far_id);
+    };
+    
+    int run_start = -1;
+    
+    for (int offset = 0; offset <= length; ++offset)
+    {
+        bool open = false;
+        
+        if (offset < length)
+        {
+            vector2_i near_cell({ first.x + step.x * offset, first.y + step.y * offset });
+            vector2_i far_cell({ near_cell.x + across.x, near_cell.y + across.y });
+            open = (!walls.is_blocked(near_cell) && !walls.is_blocked(far_cell));
+        }
+        
+        if (open && run_start < 0)
+        {
+            run_start = offset;
+        }
+        else if (!open && run_start >= 0)
+        {
+            const int run_end = offset - 1;
+            
+            if (run_end - run_start + 1 >= wide_entrance)
+            {
+                add_entrance(run_start);
+                add_entrance(run_end);
+            }
+            else
+            {
+                add_entrance((run_start + run_end) / 2);
+            }
+            
+            run_start = -1;
+        }
+    }
+}
+
+void hierarchical_planner::gather_nodes(uint32_t _cluster, std::vector<uint32_t>& _out) const
+{
+    const int cx = static_cast<int>(_cluster) % clusters_x;
+    const int cy = static_cast<int>(_cluster) / clusters_x;
+    
+    _out.clear();
+    _out.insert(_out.end(), east_borders[_cluster].near_nodes.begin(), east_borders[_cluster].near_nodes.end());
+    _out.insert(_out.end(), north_borders[_cluster].near_nodes.begin(), north_borders[_cluster].near_nodes.end());
+    
+    if (cx > 0)
+    {
+        const border& west = east_borders[_cluster - 1];
+        _out.insert(_out.end(), west.far_nodes.begin(), west.far_nodes.end());
+    }
+    
+    if (cy > 0)
+    {
+        const border& south = north_borders[_cluster - clusters_x];
+        _out.insert(_out.end(), south.far_nodes.begin(), south.far_nodes.end());
+    }
+}
+
+void hierarchical_planner::build_edges(uint32_t _cluster)
+{
+    std::vector<uint32_t> members;
+    gather_nodes(_cluster, members);
+    
+    for (auto from : members)
+    {
+        nodes[from].edges.clear();
+        search_cluster(_cluster, nodes[from].position, nullptr);
+        
+        for (auto to : members)
+        {
+            if (to == from)
+                continue;
+            
+            uint32_t id = local_index(nodes[to].position);
+            
+            if (local_cells.get_state(id) != node_state::NONE)
+                nodes[from].edges.push_back(edge(to, local_cells.get_g(id)));
+        }
+    }
+}
+
+void hierarchical_planner::search_cluster(uint32_t _cluster, vector2_i _from, const vector2_i* _to)
+{
+    search_window(_cluster, _cluster, _from, _to);
+}
+
+bool hierarchical_planner::are_neighbors(uint32_t _first, uint32_t _second) const
+{
+    const int dx = static_cast<int>(_first) % clusters_x - static_cast<int>(_second) % clusters_x;
+    const int dy = static_cast<int>(_first) / clusters_x - static_cast<int>(_second) / clusters_x;
+    
+    return (abs(dx) <= 1 && abs(dy) <= 1);
+}
+
+void hierarchical_planner::search_window(uint32_t _first, uint32_t _second, vector2_i _from, const vector2_i* _to)
+{
+    const int min_x = std::min(static_cast<int>(_first) % clusters_x, static_cast<int>(_second) % clusters_x);
+    const int min_y = std::min(static_cast<int>(_first) / clusters_x, static_cast<int>(_second) / clusters_x);
+    const int max_x = std::max(static_cast<int>(_first) % clusters_x, static_cast<int>(_second) % clusters_x);
+    const int max_y = std::max(static_cast<int>(_first) / clusters_x, static_cast<int>(_second) / clusters_x);
+    
+    const int directions = (diagonal ? 8 : 4);
+    const std::size_t count = static_cast<std::size_t>(4) * cluster_size * cluster_size;
+    
+    local_stride = 2 * cluster_size;
+    local_origin = { min_x * cluster_size, min_y * cluster_size };
+    local_extent = { std::min((max_x + 1) * cluster_size, built_size.x) - local_origin.x, 
+                     std::min((max_y + 1) * cluster_size, built_size.y) - local_origin.y };
+    
+    const int end_x = local_origin.x + local_extent.x;
+    const int end_y = local_origin.y + local_extent.y;
+    
+    local_cells.resize(count);
+    local_cells.reset();
+    local_open.reset(count);
+    
+    uint32_t start = local_index(_from);
+    local_cells.open(start, 0, search_grid::no_parent);
+    local_open.push(start, 0, 0);
+    
+    while (!local_open.empty())
+    {
+        const uint32_t current = local_open.pop();
+        const int x = local_origin.x + static_cast<int>(current) % local_stride;
+        const int y = local_origin.y + static_cast<int>(current) / local_stride;
+        
+        local_cells.close(current);
+        
+        if (_to != nullptr && x == _to->x && y == _to->y)
+            break;
+        
+        const int32_t g = local_cells.get_g(current);
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = x + grid_direction_x[i];
+            const int ny = y + grid_direction_y[i];
+            
+            if (  nx < local_origin.x || nx >= end_x
+               || ny < local_origin.y || ny >= end_y
+               || walls.is_blocked(nx, ny))
+            {
+                continue;
+            }
+            
+            const uint32_t id = local_index(nx, ny);
+            const node_state state = local_cells.get_state(id);
+            const int32_t total_cost = g + (i < 4 ? 10 : 14);
+            
+            if (state == node_state::IN_CLOSED_LIST)
+                continue;
+            
+            if (state == node_state::IN_OPEN_LIST)
+            {
+                if (total_cost < local_cells.get_g(id))
+                {
+                    local_cells.open(id, total_cost, static_cast<uint8_t>(i));
+                    local_open.decrease(id, total_cost, total_cost);
+                }
+            }
+            else
+            {
+                local_cells.open(id, total_cost, static_cast<uint8_t>(i));
+                local_open.push(id, total_cost, total_cost);
+            }
+        }
+    }
+}
+
+vector2_array_i hierarchical_planner::find_waypoints(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    expansions = 0;
+    
+    if (_diagonal != diagonal)
+    {
+        diagonal = _diagonal;
+        built = false;
+    }
+    
+    update();
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    const uint32_t start_cluster = cluster_of(_start);
+    const uint32_t goal_cluster = cluster_of(_goal);
+    const int32_t unreachable = std::numeric_limits<int32_t>::max();
+    
+    int32_t best = unreachable;
+    uint32_t best_exit = none;
+    
+    std::vector<uint32_t> members;
+    std::vector<edge> start_links;
+    std::vector<edge> goal_links;
+    
+    // Connect the start and goal to the nodes of their clusters
+    gather_nodes(start_cluster, members);
+    search_cluster(start_cluster, _start, nullptr);
+    
+    for (auto id : members)
+    {
+        uint32_t local = local_index(nodes[id].position);
+        
+        if (local_cells.get_state(local) != node_state::NONE)
+            start_links.push_back(edge(id, local_cells.get_g(local)));
+    }
+    
+    if (start_cluster == goal_cluster && local_cells.get_state(local_index(_goal)) != node_state::NONE)
+        best = local_cells.get_g(local_index(_goal));
+    
+    // Short queries would detour through entrance cells, search them exactly
+    if (start_cluster != goal_cluster && are_neighbors(start_cluster, goal_cluster))
+    {
+        search_window(start_cluster, goal_cluster, _start, &_goal);
+        
+        if (local_cells.get_state(local_index(_goal)) == node_state::IN_CLOSED_LIST)
+            best = local_cells.get_g(local_index(_goal));
+    }
+    
+    gather_nodes(goal_cluster, members);
+    search_cluster(goal_cluster, _goal, nullptr);
+    
+    for (auto id : members)
+    {
+        uint32_t local = local_index(nodes[id].position);
+        
+        if (local_cells.get_state(local) != node_state::NONE)
+            goal_links.push_back(edge(id, local_cells.get_g(local)));
+    }
+    
+    // A* over the abstract graph, stopped once nothing in the open list can 
+    // beat the cheapest way found into the goal
+    abstract_cells.resize(nodes.size());
+    abstract_cells.reset();
+    abstract_open.reset(nodes.size());
+    
+    if (abstract_parents.size() < nodes.size())
+        abstract_parents.resize(nodes.size());
+    
+    for (auto& link : start_links)
+    {
+        if (abstract_cells.get_state(link.first) == node_state::IN_OPEN_LIST)
+            continue;
+        
+        abstract_cells.open(link.first, link.second, 0);
+        abstract_parents[link.first] = none;
+        abstract_open.push(link.first, link.second + _heuristic(nodes[link.first].position, _goal), link.second);
+    }
+    
+    while (!abstract_open.empty() && abstract_open.top_f() < best)
+    {
+        const uint32_t current = abstract_open.pop();
+        const int32_t g = abstract_cells.get_g(current);
+        
+        ++expansions;
+        abstract_cells.close(current);
+        
+        if (nodes[current].cluster == goal_cluster)
+        {
+            for (auto& link : goal_links)
+            {
+                if (link.first == current && g + link.second < best)
+                {
+                    best = g + link.second;
+                    best_exit = current;
+                }
+            }
+        }
+        
+        auto relax = [&](uint32_t _to, int32_t _cost)
+        {
+            const node_state state = abstract_cells.get_state(_to);
+            const int32_t total_cost = g + _cost;
+            
+            if (state == node_state::IN_CLOSED_LIST)
+                return;
+            
+            if (state == node_state::IN_OPEN_LIST && total_cost >= abstract_cells.get_g(_to))
+                return;
+            
+            const double f = total_cost + _heuristic(nodes[_to].position, _goal);
+            
+            if (state == node_state::IN_OPEN_LIST)
+                abstract_open.decrease(_to, f, total_cost);
+            else
+                abstract_open.push(_to, f, total_cost);
+            
+            abstract_cells.open(_to, total_cost, 0);
+            abstract_parents[_to] = current;
+        };
+        
+        relax(nodes[current].partner, 10);
+        
+        for (auto& link : nodes[current].edges)
+            relax(link.first, link.second);
+    }
+    
+    abstract_open.clear();
+    
+    if (best == unreachable)
+        return {};
+    
+    vector2_array_i waypoints;
+    waypoints.push_back(_goal);
+    
+    for (uint32_t id = best_exit; id != none; id = abstract_parents[id])
+        waypoints.push_back(nodes[id].position);
+    
+    waypoints.push_back(_start);
+    return waypoints;
+}
+
+vector2_array_i hierarchical_planner::refine_segment(vector2_i _from, vector2_i _to)
+{
+    if (_from == static_cast<vector2_i>(_to))
+        return { _to };
+    
+    if (!built || walls.is_blocked(_from) || walls.is_blocked(_to))
+        return {};
+    
+    const uint32_t from_cluster = cluster_of(_from);
+    const uint32_t to_cluster = cluster_of(_to);
+    
+    // Waypoints are the two sides of an entrance, nodes of one cluster, or a
+    // start and goal in neighboring clusters
+    if (!are_neighbors(from_cluster, to_cluster))
+        return {};
+    
+    search_window(from_cluster, to_cluster, _from, &_to);
+    
+    if (local_cells.get_state(local_index(_to)) != node_state::IN_CLOSED_LIST)
+        return {};
+    
+    vector2_array_i segment;
+    vector2_i position = _to;
+    
+    for (;;)
+    {
+        segment.push_back(position);
+        
+        uint8_t parent = local_cells.get_parent(local_index(position));
+        
+        if (parent == search_grid::no_parent)
+            break;
+        
+        position = { position.x - grid_direction_x[parent], position.y - grid_direction_y[parent] };
+    }
+    
+    return segment;
+}
+
+vector2_array_i hierarchical_planner::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    cost = -1;
+    bound = std::numeric_limits<double>::infinity();
+    
+    auto waypoints = find_waypoints(_start, _goal, _diagonal, _heuristic);
+    
+    if (waypoints.empty())
+        return {};
+    
+    vector2_array_i path;
+    
+    for (std::size_t i = 0; i + 1 < waypoints.size(); ++i)
+    {
+        auto segment = refine_segment(waypoints[i + 1], waypoints[i]);
+        
+        if (segment.empty())
+            return {};
+        
+        path.insert(path.end(), segment.begin(), segment.end() - 1);
+    }
+    
+    path.push_back(waypoints.back());
+    
+    cost = 0;
+    
+    for (std::size_t i = 1; i < path.size(); ++i)
+        cost += (path[i].x != path[i - 1].x && path[i].y != path[i - 1].y ? 14 : 10);
+    
+    // The optimal cost is at least the heuristic when it never overestimates
+    const int lower = _heuristic(_start, _goal);
+    
+    if (cost == 0)
+        bound = 1.0;
+    else if (lower > 0)
+        bound = std::max(1.0, static_cast<double>(cost) / lower);
+    
+    return path;
+}
@@ -0,0 +1,194 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HIERARCHICAL_PLANNER_H
+#define HIERARCHICAL_PLANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Hierarchical pathfinding (HPA*) over an occupancy grid.
+ * 
+ * The world is cut into square clusters.  Every run of free cells along a 
+ * border between two clusters gets one entrance (two for runs of 6 or more 
+ * cells) made of a node on each side.  Nodes of the same cluster are linked
+ * by their exact distance inside the cluster.  Queries search this abstract 
+ * graph and then refine each abstract edge with a search bounded to one 
+ * cluster.  Start and goal in the same or neighboring clusters are also 
+ * joined directly by an exact search over those clusters.
+ * 
+ * Changing a cell only rebuilds the cluster that holds it, plus the 
+ * neighboring cluster when the cell lies on their shared border.  The 
+ * rebuild runs lazily on the next query.
+ * 
+ * Paths have no fixed bound on their cost over the optimal one, since 
+ * entrances only cover one or two cells of each border.  Every query 
+ * reports a bound of its own instead, see get_bound.  With 
+ * set_hierarchical_guarantee path_builder searches again the paths that 
+ * bound does not prove within its suboptimality.
+ */
+class hierarchical_planner
+{
+    
+public:
+    
+    explicit hierarchical_planner(const occupancy_grid& _walls, int _cluster_size = 16);
+    
+    // Rebuilds the whole abstraction on the next query
+    void set_cluster_size(int _cluster_size);
+    void invalidate_all();
+    
+    // Marks the clusters that depend on a changed cell
+    void invalidate(vector2_i _coordinates);
+    
+    // Every cell of the path from _goal back to _start, like find_path
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    // Abstract path from _goal back to _start, without refinement
+    vector2_array_i find_waypoints(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    // Cells from _to back to _from for two consecutive waypoints
+    vector2_array_i refine_segment(vector2_i _from, vector2_i _to);
+    
+    // Abstract nodes expanded by the last query
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    // Cost of the last path in 10/14 units, -1 if there was none
+    inline int32_t get_cost() const { return cost; }
+    
+    // Upper bound on cost / optimal cost of the last path: its cost over the 
+    // heuristic from start to goal, which holds for any heuristic that never 
+    // overestimates.  Infinity if there was no path.
+    inline double get_bound() const { return bound; }
+    
+    // Clusters rebuilt since the planner was created
+    inline std::size_t get_rebuilt_clusters() const { return rebuilt_clusters; }
+    
+    std::size_t get_node_count() const;
+    
+private:
+    
+    typedef std::pair<uint32_t, int32_t> edge;   // target node, cost
+    
+    static const uint32_t none = UINT32_MAX;
+    
+    struct abstract_node
+    {
+        vector2_i position;
+        uint32_t cluster;
+        uint32_t partner;               // node on the other side of the entrance
+        bool alive;
+        std::vector<edge> edges;        // nodes of the same cluster
+    };
+    
+    // Entrances between a cluster and its east or north neighbor
+    struct border
+    {
+        bool dirty;
+        std::vector<uint32_t> near_nodes;   // inside the cluster
+        std::vector<uint32_t> far_nodes;    // inside the neighbor
+    };
+    
+    const occupancy_grid& walls;
+    int cluster_size;
+    int clusters_x;
+    int clusters_y;
+    vector2_i built_size;
+    bool diagonal;
+    bool built;
+    std::size_t expansions;
+    std::size_t rebuilt_clusters;
+    int32_t cost;
+    double bound;
+    
+    std::vector<abstract_node> nodes;
+    std::vector<uint32_t> free_nodes;
+    std::vector<border> east_borders;
+    std::vector<border> north_borders;
+    std::vector<char> dirty;
+    std::vector<uint32_t> dirty_clusters;
+    
+    // Search bounded to a window of at most 2 x 2 clusters, indexed by local cell
+    search_grid local_cells;
+    indexed_heap<double, 2> local_open;
+    vector2_i local_origin;
+    vector2_i local_extent;
+    int local_stride;
+    
+    // Search over the abstract graph, indexed by node
+    search_grid abstract_cells;
+    std::vector<uint32_t> abstract_parents;
+    indexed_heap<double, 2> abstract_open;
+    
+    inline uint32_t cluster_of(vector2_i _coordinates) const
+    {
+        return static_cast<uint32_t>((_coordinates.y / cluster_size) * clusters_x + _coordinates.x / cluster_size);
+    }
+    
+    inline uint32_t local_index(int _x, int _y) const
+    {
+        return static_cast<uint32_t>((_y - local_origin.y) * local_stride + (_x - local_origin.x));
+    }
+    
+    inline uint32_t local_index(vector2_i _coordinates) const
+    {
+        return local_index(_coordinates.x, _coordinates.y);
+    }
+    
+    void update();
+    void rebuild();
+    void mark_dirty(int _cluster_x, int _cluster_y);
+    void release_border(border& _border);
+    void build_border(int _cluster_x, int _cluster_y, bool _east);
+    void build_edges(uint32_t _cluster);
+    void gather_nodes(uint32_t _cluster, std::vector<uint32_t>& _out) const;
+    uint32_t create_node(vector2_i _position, uint32_t _cluster);
+    
+    // Dijkstra from _from inside _cluster, stopping early at _to if given
+    void search_cluster(uint32_t _cluster, vector2_i _from, const vector2_i* _to);
+    
+    // Same search inside the smallest box of clusters holding both cells.
+    // The clusters have to be neighbors.
+    void search_window(uint32_t _first, uint32_t _second, vector2_i _from, const vector2_i* _to);
+    
+    bool are_neighbors(uint32_t _first, uint32_t _second) const;
+    
+};
+
+#endif /* HIERARCHICAL_PLANNER_H */
@@ -0,0 +1,248 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <assert.h>
+
+/*
+ * D-ary min-heap of grid cells keyed on f = g + h.
+ * 
+ * Every cell id owns a slot in a position table, so membership tests and 
+ * decrease-key are O(1) lookups followed by an O(log n) sift.  Ties on f 
+ * prefer the larger g, which pops nodes closer to the goal first.
+ */
+template<typename T, std::size_t D = 2>
+class indexed_heap
+{
+    
+public:
+    
+    static const uint32_t npos = UINT32_MAX;
+    
+    explicit indexed_heap() {}
+    
+    // Sizes the position table for a grid of _cells and empties the heap
+    void reset(std::size_t _cells)
+    {
+        clear();
+        
+        if (positions.size() != _cells)
+            positions.assign(_cells, npos);
+    }
+    
+    // Empties the heap, touching only the cells that are still queued
+    void clear()
+    {
+        for (auto& item : entries)
+            positions[item.id] = npos;
+        
+        entries.clear();
+    }
+    
+    inline bool empty() const { return entries.empty(); }
+    inline std::size_t size() const { return entries.size(); }
+    
+    inline bool contains(uint32_t _id) const 
+    { 
+        return (_id < positions.size() && positions[_id] != npos); 
+    }
+    
+    inline uint32_t top() const 
+    { 
+        assert(!entries.empty());
+        return entries.front().id; 
+    }
+    
+    inline T top_f() const
+    {
+        assert(!entries.empty());
+        return entries.front().f;
+    }
+    
+    inline T top_g() const
+    {
+        assert(!entries.empty());
+        return entries.front().g;
+    }
+    
+    void push(uint32_t _id, T _f, T _g)
+    {
+        assert(!contains(_id));
+        
+        entries.push_back({ _f, _g, _id });
+        positions[_id] = static_cast<uint32_t>(entries.size() - 1);
+        sift_up(entries.size() - 1);
+    }
+    
+    // Lowers the key of a queued cell
+    void decrease(uint32_t _id, T _f, T _g)
+    {
+        assert(contains(_id));
+        
+        std::size_t index = positions[_id];
+        entries[index].f = _f;
+        entries[index].g = _g;
+        sift_up(index);
+    }
+    
+    // Moves a queued cell to a new key that may be higher or lower
+    void update(uint32_t _id, T _f, T _g)
+    {
+        assert(contains(_id));
+        
+        std::size_t index = positions[_id];
+        entry item = { _f, _g, _id };
+        bool raised = less(entries[index], item);
+        entries[index] = item;
+        
+        if (raised)
+            sift_down(index);
+        else
+            sift_up(index);
+    }
+    
+    // Takes a queued cell out of the heap
+    void remove(uint32_t _id)
+    {
+        assert(contains(_id));
+        
+        std::size_t index = positions[_id];
+        positions[_id] = npos;
+        
+        entry last = entries.back();
+        entries.pop_back();
+        
+        if (index == entries.size())
+            return;
+        
+        place(index, last);
+        
+        if (index > 0 && less(last, entries[(index - 1) / D]))
+            sift_up(index);
+        else
+            sift_down(index);
+    }
+    
+    uint32_t pop()
+    {
+        assert(!entries.empty());
+        
+        uint32_t id = entries.front().id;
+        positions[id] = npos;
+        
+        if (entries.size() > 1)
+        {
+            entries.front() = entries.back();
+            positions[entries.front().id] = 0;
+            entries.pop_back();
+            sift_down(0);
+        }
+        else
+        {
+            entries.pop_back();
+        }
+        
+        return id;
+    }
+    
+private:
+    
+    struct entry
+    {
+        T f;
+        T g;
+        uint32_t id;
+    };
+    
+    std::vector<entry> entries;
+    std::vector<uint32_t> positions; // cell id -> index in entries
+    
+    inline static bool less(const entry& A, const entry& B)
+    {
+        return (A.f < B.f || (A.f == B.f && A.g > B.g));
+    }
+    
+    inline void place(std::size_t _index, const entry& _item)
+    {
+        entries[_index] = _item;
+        positions[_item.id] = static_cast<uint32_t>(_index);
+    }
+    
+    void sift_up(std::size_t _index)
+    {
+        entry item = entries[_index];
+        
+        while (_index > 0)
+        {
+            std::size_t parent = (_index - 1) / D;
+            
+            if (!less(item, entries[parent]))
+                break;
+            
+            place(_index, entries[parent]);
+            _index = parent;
+        }
+        
+        place(_index, item);
+    }
+    
+    void sift_down(std::size_t _index)
+    {
+        entry item = entries[_index];
+        const std::size_t count = entries.size();
+        
+        for (;;)
+        {
+            std::size_t first = _index * D + 1;
+            
+            if (first >= count)
+                break;
+            
+            std::size_t last = (first + D < count ? first + D : count);
+            std::size_t best = first;
+            
+            for (std::size_t child = first + 1; child < last; ++child)
+                if (less(entries[child], entries[best]))
+                    best = child;
+            
+            if (!less(entries[best], item))
+                break;
+            
+            place(_index, entries[best]);
+            _index = best;
+        }
+        
+        place(_index, item);
+    }
+    
+};
+
+template<typename T, std::size_t D>
+const uint32_t indexed_heap<T, D>::npos;
+
+#endif /* INDEXED_HEAP_H */
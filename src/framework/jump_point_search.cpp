@@ -0,0 +1,315 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "jump_point_search.h"
+#include <cstdlib>
+#include <algorithm>
+
+namespace
+{
+    inline int sign(int _value) { return (_value > 0) - (_value < 0); }
+    
+    const vector2_i octile_directions[8] =
+    {
+        { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
+        { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }
+    };
+}
+
+jump_point_search::jump_point_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , expansions(0)
+    , goal({ 0, 0 })
+    , diagonal(true)
+    , width(0)
+{}
+
+vector2_array_i jump_point_search::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    expansions = 0;
+    
+    if (!walls.is_inside(_start))
+        return {};
+    
+    goal = _goal;
+    diagonal = _diagonal;
+    width = walls.get_size().x;
+    
+    const std::size_t count = static_cast<std::size_t>(width) * walls.get_size().y;
+    
+    open.reset(count);
+    cells.resize(count);
+    cells.reset();
+    
+    if (parents.size() != count)
+        parents.assign(count, 0);
+    
+    const uint32_t start = cell_index(_start);
+    uint32_t current = start;
+    
+    cells.open(start, 0, search_grid::no_parent);
+    parents[start] = start;
+    open.push(start, 0, 0);
+    
+    vector2_i directions[8];
+    
+    while (!open.empty())
+    {
+        current = open.pop();
+        
+        const vector2_i position = cell_position(current);
+        
+        if (position == goal)
+            break;
+        
+        ++expansions;
+        cells.close(current);
+        
+        int branches = 0;
+        
+        if (current == start)
+        {
+            branches = (diagonal ? 8 : 4);
+            std::copy(octile_directions, octile_directions + branches, directions);
+        }
+        else
+        {
+            const vector2_i parent = cell_position(parents[current]);
+            const int dx = sign(position.x - parent.x);
+            const int dy = sign(position.y - parent.y);
+            
+            branches = (diagonal 
+                ? prune_octile(position, dx, dy, directions) 
+                : prune_cardinal(position, dx, dy, directions));
+        }
+        
+        const int32_t g = cells.get_g(current);
+        
+        for (int i = 0; i < branches; ++i)
+        {
+            vector2_i jump_point;
+            
+            bool found = (diagonal 
+                ? jump_octile(position, directions[i].x, directions[i].y, jump_point) 
+                : jump_cardinal(position, directions[i].x, directions[i].y, jump_point));
+            
+            if (!found)
+                continue;
+            
+            const uint32_t id = cell_index(jump_point);
+            const node_state state = cells.get_state(id);
+            
+            if (state == node_state::IN_CLOSED_LIST)
+                continue;
+            
+            // Runs between jump points are straight or diagonal lines
+            const int steps = std::max(abs(jump_point.x - position.x), abs(jump_point.y - position.y));
+            const int32_t total_cost = g + steps * (directions[i].x && directions[i].y ? 14 : 10);
+            
+            if (state == node_state::IN_OPEN_LIST && total_cost >= cells.get_g(id))
+                continue;
+            
+            const double f = total_cost + _heuristic(jump_point, goal);
+            
+            if (state == node_state::IN_OPEN_LIST)
+                open.decrease(id, f, total_cost);
+            else
+                open.push(id, f, total_cost);
+            
+            cells.open(id, total_cost, 0);
+            parents[id] = current;
+        }
+    }
+    
+    // Fill in the cells between jump points
+    vector2_array_i path;
+    vector2_i position = cell_position(current);
+    
+    path.push_back(position);
+    
+    for (uint32_t id = current; id != start; id = parents[id])
+    {
+        const vector2_i parent = cell_position(parents[id]);
+        const int dx = sign(parent.x - position.x);
+        const int dy = sign(parent.y - position.y);
+        
+        while (position != parent)
+        {
+            position = { position.x + dx, position.y + dy };
+            path.push_back(position);
+        }
+    }
+    
+    open.clear();
+    return path;
+}
+
+int jump_point_search::prune_octile(vector2_i _position, int _dx, int _dy, vector2_i* _directions) const
+{
+    const int x = _position.x;
+    const int y = _position.y;
+    int count = 0;
+    
+    if (_dx != 0 && _dy != 0)
+    {
+        _directions[count++] = { _dx, 0 };
+        _directions[count++] = { 0, _dy };
+        _directions[count++] = { _dx, _dy };
+        
+        if (!is_free(x - _dx, y)) _directions[count++] = { -_dx, _dy };
+        if (!is_free(x, y - _dy)) _directions[count++] = { _dx, -_dy };
+    }
+    else if (_dx != 0)
+    {
+        _directions[count++] = { _dx, 0 };
+        
+        if (!is_free(x, y + 1)) _directions[count++] = { _dx, 1 };
+        if (!is_free(x, y - 1)) _directions[count++] = { _dx, -1 };
+    }
+    else
+    {
+        _directions[count++] = { 0, _dy };
+        
+        if (!is_free(x + 1, y)) _directions[count++] = { 1, _dy };
+        if (!is_free(x - 1, y)) _directions[count++] = { -1, _dy };
+    }
+    
+    return count;
+}
+
+// Shortest 4-connected paths can always be reordered to turn from horizontal 
+// to vertical only where the cell diagonally behind is blocked, so horizontal 
+// runs only stop there and vertical runs may turn anywhere
+int jump_point_search::prune_cardinal(vector2_i _position, int _dx, int _dy, vector2_i* _directions) const
+{
+    const int x = _position.x;
+    const int y = _position.y;
+    int count = 0;
+    
+    if (_dx != 0)
+    {
+        _directions[count++] = { _dx, 0 };
+        
+        if (!is_free(x - _dx, y + 1)) _directions[count++] = { 0, 1 };
+        if (!is_free(x - _dx, y - 1)) _directions[count++] = { 0, -1 };
+    }
+    else
+    {
+        _directions[count++] = { 0, _dy };
+        _directions[count++] = { 1, 0 };
+        _directions[count++] = { -1, 0 };
+    }
+    
+    return count;
+}
+
+bool jump_point_search::jump_octile(vector2_i _from, int _dx, int _dy, vector2_i& _jump_point) const
+{
+    int x = _from.x;
+    int y = _from.y;
+    
+    for (;;)
+    {
+        x += _dx;
+        y += _dy;
+        
+        if (!is_free(x, y))
+            return false;
+        
+        bool forced = false;
+        
+        if (x == goal.x && y == goal.y)
+        {
+            forced = true;
+        }
+        else if (_dx != 0 && _dy != 0)
+        {
+            vector2_i ignored;
+            
+            forced = ((is_free(x - _dx, y + _dy) && !is_free(x - _dx, y))
+                   || (is_free(x + _dx, y - _dy) && !is_free(x, y - _dy))
+                   || jump_octile({ x, y }, _dx, 0, ignored)
+                   || jump_octile({ x, y }, 0, _dy, ignored));
+        }
+        else if (_dx != 0)
+        {
+            forced = ((is_free(x + _dx, y + 1) && !is_free(x, y + 1))
+                   || (is_free(x + _dx, y - 1) && !is_free(x, y - 1)));
+        }
+        else
+        {
+            forced = ((is_free(x + 1, y + _dy) && !is_free(x + 1, y))
+                   || (is_free(x - 1, y + _dy) && !is_free(x - 1, y)));
+        }
+        
+        if (forced)
+        {
+            _jump_point = { x, y };
+            return true;
+        }
+    }
+}
+
+bool jump_point_search::jump_cardinal(vector2_i _from, int _dx, int _dy, vector2_i& _jump_point) const
+{
+    int x = _from.x;
+    int y = _from.y;
+    
+    for (;;)
+    {
+        x += _dx;
+        y += _dy;
+        
+        if (!is_free(x, y))
+            return false;
+        
+        bool forced = false;
+        
+        if (x == goal.x && y == goal.y)
+        {
+            forced = true;
+        }
+        else if (_dx != 0)
+        {
+            forced = ((is_free(x, y + 1) && !is_free(x - _dx, y + 1))
+                   || (is_free(x, y - 1) && !is_free(x - _dx, y - 1)));
+        }
+        else
+        {
+            vector2_i ignored;
+            
+            forced = (jump_cardinal({ x, y }, 1, 0, ignored)
+                   || jump_cardinal({ x, y }, -1, 0, ignored));
+        }
+        
+        if (forced)
+        {
+            _jump_point = { x, y };
+            return true;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef JUMP_POINT_SEARCH_H
+#define JUMP_POINT_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Jump Point Search over an occupancy grid with the 10/14 step costs.
+ * 
+ * Only jump points enter the open list: the start, the goal and cells with 
+ * forced neighbors.  Straight runs between them are skipped without being 
+ * queued.  8-connected search follows the same diagonal rule as find_path 
+ * (diagonals may pass blocked corners).  4-connected search scans 
+ * horizontally from every vertical step, the way diagonal steps scan in 
+ * 8-connected search.  Both return optimal paths with a consistent heuristic.
+ */
+class jump_point_search
+{
+    
+public:
+    
+    explicit jump_point_search(const occupancy_grid& _walls);
+    
+    // Every cell of the path from _goal back to _start, like find_path
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    // Jump points expanded by the last call to find_path
+    inline std::size_t get_expansions() const { return expansions; }
+    
+private:
+    
+    const occupancy_grid& walls;
+    search_grid cells;
+    std::vector<uint32_t> parents;  // cell id -> jump point it was reached from
+    indexed_heap<double, 2> open;
+    std::size_t expansions;
+    
+    vector2_i goal;
+    bool diagonal;
+    int width;
+    
+    inline bool is_free(int _x, int _y) const { return !walls.is_blocked(_x, _y); }
+    
+    inline uint32_t cell_index(vector2_i _coordinates) const 
+    { 
+        return static_cast<uint32_t>(_coordinates.y * width + _coordinates.x); 
+    }
+    
+    inline vector2_i cell_position(uint32_t _id) const
+    {
+        return { static_cast<int>(_id % width), static_cast<int>(_id / width) };
+    }
+    
+    // Directions worth searching from a jump point entered moving (_dx, _dy)
+    int prune_octile(vector2_i _position, int _dx, int _dy, vector2_i* _directions) const;
+    int prune_cardinal(vector2_i _position, int _dx, int _dy, vector2_i* _directions) const;
+    
+    // Walks from _from in (_dx, _dy) until a jump point or a collision
+    bool jump_octile(vector2_i _from, int _dx, int _dy, vector2_i& _jump_point) const;
+    bool jump_cardinal(vector2_i _from, int _dx, int _dy, vector2_i& _jump_point) const;
+    
+};
+
+#endif /* JUMP_POINT_SEARCH_H */
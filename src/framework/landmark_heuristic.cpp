@@ -0,0 +1,253 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "landmark_heuristic.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <framework/flow_field.h>
+#include <framework/search_kernel.h>
+#include <parallel/thread_pool.h>
+
+namespace
+{
+    // Calls _job for every index below _count on up to _threads tasks
+    void run_parallel(thread_pool& _pool, std::size_t _threads, std::size_t _count, 
+        const std::function<void(std::size_t)>& _job)
+    {
+        std::atomic<std::size_t> next(0);
+        
+        auto work = [&]()
+        {
+            for (std::size_t i = next++; i < _count; i = next++)
+                _job(i);
+        };
+        
+        std::vector<std::future<void>> tasks;
+        
+        try
+        {
+            for (std::size_t t = 1; t < std::min(_threads, _count); ++t)
+                tasks.push_back(_pool.enqueue(work));
+        }
+        catch (const std::runtime_error&) {}
+        
+        work();
+        
+        for (auto& task : tasks)
+            task.get();
+    }
+    
+    // Farthest free cell from the center in one angular sector
+    struct candidate
+    {
+        int64_t score;
+        vector2_i cell;
+    };
+}
+
+landmark_heuristic::landmark_heuristic() {}
+
+landmark_heuristic landmark_heuristic::build(
+      const occupancy_grid& _walls
+    , std::size_t _count
+    , bool _diagonal
+    , thread_pool& _pool
+    , std::size_t _threads)
+{
+    std::shared_ptr<tables> built = std::make_shared<tables>();
+    built->size = _walls.get_size();
+    built->diagonal = _diagonal;
+    
+    const vector2_i size = built->size;
+    const std::size_t cells = static_cast<std::size_t>(size.x) * size.y;
+    
+    if (cells == 0 || _count == 0)
+        return landmark_heuristic();
+    
+    _threads = std::max<std::size_t>(1, _threads);
+    
+    // Each band of rows finds its best cell of every sector, then the bands are merged
+    const int band_height = 64;
+    const std::size_t bands = static_cast<std::size_t>((size.y + band_height - 1) / band_height);
+    const double center_x = 0.5 * (size.x - 1);
+    const double center_y = 0.5 * (size.y - 1);
+    const double pi = std::acos(-1.0);
+    
+    std::vector<std::vector<candidate>> best(bands, std::vector<candidate>(_count, candidate{ -1, { 0, 0 } }));
+    
+    run_parallel(_pool, _threads, bands, [&](std::size_t _band)
+    {
+        const int last = std::min(size.y, static_cast<int>(_band + 1) * band_height);
+        
+        for (int y = static_cast<int>(_band) * band_height; y < last; ++y)
+        {
+            for (int x = 0; x < size.x; ++x)
+            {
+                if (_walls.is_blocked(x, y))
+                    continue;
+                
+                const double angle = std::atan2(y - center_y, x - center_x) + pi;
+                std::size_t sector = static_cast<std::size_t>(angle / (2.0 * pi) * _count);
+                sector = std::min(sector, _count - 1);
+                
+                const int64_t dx = 2 * x - (size.x - 1);
+                const int64_t dy = 2 * y - (size.y - 1);
+                const int64_t score = dx * dx + dy * dy;
+                
+                if (score > best[_band][sector].score)
+                    best[_band][sector] = { score, { x, y } };
+            }
+        }
+    });
+    
+    for (std::size_t sector = 0; sector < _count; ++sector)
+    {
+        candidate chosen = { -1, { 0, 0 } };
+        
+        for (std::size_t band = 0; band < bands; ++band)
+            if (best[band][sector].score > chosen.score)
+                chosen = best[band][sector];
+        
+        if (chosen.score >= 0)
+            built->landmarks.push_back(chosen.cell);
+    }
+    
+    const std::size_t landmarks = built->landmarks.size();
+    
+    if (landmarks == 0)
+        return landmark_heuristic();
+    
+    // One Dijkstra per landmark, then the tables are interleaved by cell
+    std::vector<std::vector<int32_t>> distances(landmarks);
+    
+    run_parallel(_pool, _threads, landmarks, [&](std::size_t _landmark)
+    {
+        flow_field field(_walls);
+        field.update(built->landmarks[_landmark], _diagonal);
+        distances[_landmark] = field.get_distances();
+    });
+    
+    built->distances.resize(cells * landmarks);
+    
+    run_parallel(_pool, _threads, bands, [&](std::size_t _band)
+    {
+        const std::size_t first = _band * band_height * static_cast<std::size_t>(size.x);
+        const std::size_t last = std::min(cells, first + band_height * static_cast<std::size_t>(size.x));
+        
+        for (std::size_t cell = first; cell < last; ++cell)
+            for (std::size_t k = 0; k < landmarks; ++k)
+                built->distances[cell * landmarks + k] = distances[k][cell];
+    });
+    
+    landmark_heuristic heuristic;
+    heuristic.data = built;
+    
+    return heuristic;
+}
+
+int landmark_heuristic::operator()(vector2_i _current, vector2_i _goal) const
+{
+    if (!data)
+        return octagonal_policy()(_current, _goal);
+    
+    int best = (data->diagonal 
+        ? octagonal_policy()(_current, _goal) 
+        : manhattan_policy()(_current, _goal));
+    
+    const vector2_i size = data->size;
+    
+    if (static_cast<unsigned>(_current.x) >= static_cast<unsigned>(size.x) 
+        || static_cast<unsigned>(_current.y) >= static_cast<unsigned>(size.y)
+        || static_cast<unsigned>(_goal.x) >= static_cast<unsigned>(size.x) 
+        || static_cast<unsigned>(_goal.y) >= static_cast<unsigned>(size.y))
+        return best;
+    
+    const std::size_t count = data->landmarks.size();
+    const int32_t* current = &data->distances[(static_cast<std::size_t>(_current.y) * size.x + _current.x) * count];
+    const int32_t* goal = &data->distances[(static_cast<std::size_t>(_goal.y) * size.x + _goal.x) * count];
+    
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        // A landmark that cannot reach both cells bounds nothing
+        if (current[k] == flow_field::unreachable || goal[k] == flow_field::unreachable)
+            continue;
+        
+        best = std::max(best, static_cast<int>(std::abs(goal[k] - current[k])));
+    }
+    
+    return best;
+}
+
+void landmark_heuristic::score_neighbors(int _x, int _y, vector2_i _goal, int _count, int32_t* _h) const
+{
+    const vector2_i size = (data ? data->size : vector2_i({ 0, 0 }));
+    
+    // Neighbors on the border of the world take the slow path
+    if (!data 
+        || _x < 1 || _y < 1 || _x + 1 >= size.x || _y + 1 >= size.y
+        || static_cast<unsigned>(_goal.x) >= static_cast<unsigned>(size.x) 
+        || static_cast<unsigned>(_goal.y) >= static_cast<unsigned>(size.y))
+    {
+        for (int i = 0; i < _count; ++i)
+            _h[i] = (*this)({ _x + grid_direction_x[i], _y + grid_direction_y[i] }, _goal);
+        
+        return;
+    }
+    
+    const std::size_t count = data->landmarks.size();
+    const int32_t* goal = &data->distances[(static_cast<std::size_t>(_goal.y) * size.x + _goal.x) * count];
+    
+    for (int i = 0; i < _count; ++i)
+    {
+        const vector2_i neighbor = { _x + grid_direction_x[i], _y + grid_direction_y[i] };
+        const int32_t* current = &data->distances[(static_cast<std::size_t>(neighbor.y) * size.x + neighbor.x) * count];
+        
+        int best = (data->diagonal 
+            ? octagonal_policy()(neighbor, _goal) 
+            : manhattan_policy()(neighbor, _goal));
+        
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            if (current[k] == flow_field::unreachable || goal[k] == flow_field::unreachable)
+                continue;
+            
+            best = std::max(best, static_cast<int>(std::abs(goal[k] - current[k])));
+        }
+        
+        _h[i] = best;
+    }
+}
+
+std::vector<vector2_i> landmark_heuristic::get_landmarks() const
+{
+    return (data ? data->landmarks : std::vector<vector2_i>());
+}
+
+std::size_t landmark_heuristic::get_memory_usage() const
+{
+    return (data ? data->distances.size() * sizeof(int32_t) : 0);
+}
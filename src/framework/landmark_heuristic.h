@@ -0,0 +1,87 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LANDMARK_HEURISTIC_H
+#define LANDMARK_HEURISTIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * ALT heuristic: A*, landmarks and the triangle inequality.
+ * 
+ * Landmarks are the free cells farthest from the center of the world in 
+ * K equal angular sectors.  An exact distance table from each landmark 
+ * gives |d(L, goal) - d(L, cell)| <= d(cell, goal) for every landmark L, 
+ * and the heuristic is the largest of these bounds and the octagonal or 
+ * manhattan distance.  It stays admissible and consistent after 
+ * collisions are added, but removing collisions needs a rebuild.
+ * 
+ * Copies share the tables, so the heuristic can be handed to set_heuristic
+ * by value.
+ */
+class landmark_heuristic
+{
+    
+public:
+    
+    // Empty heuristic that falls back to the octagonal distance
+    explicit landmark_heuristic();
+    
+    // Picks _count landmarks and builds their tables on up to _threads 
+    // tasks of _pool, the calling thread included
+    static landmark_heuristic build(
+          const occupancy_grid& _walls
+        , std::size_t _count
+        , bool _diagonal
+        , class thread_pool& _pool
+        , std::size_t _threads);
+    
+    int operator()(vector2_i _current, vector2_i _goal) const;
+    
+    // Heuristic of the first _count neighbors of (_x, _y) in the order of 
+    // grid_direction_x/y, reading the landmarks of the goal once
+    void score_neighbors(int _x, int _y, vector2_i _goal, int _count, int32_t* _h) const;
+    
+    std::vector<vector2_i> get_landmarks() const;
+    std::size_t get_memory_usage() const;
+    
+private:
+    
+    struct tables
+    {
+        vector2_i size;
+        bool diagonal;
+        std::vector<vector2_i> landmarks;
+        std::vector<int32_t> distances;     // the distances of one cell to every landmark are adjacent
+    };
+    
+    std::shared_ptr<const tables> data;
+    
+};
+
+#endif /* LANDMARK_HEURISTIC_H */
@@ -0,0 +1,96 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_of_sight.h"
+#include <cstdlib>
+
+bool has_line_of_sight(const occupancy_grid& _walls, vector2_i _from, vector2_i _to, bool _diagonal)
+{
+    int x = _from.x;
+    int y = _from.y;
+    
+    if (_walls.is_blocked(x, y))
+        return false;
+    
+    const int step_x = (_to.x > x ? 1 : -1);
+    const int step_y = (_to.y > y ? 1 : -1);
+    const int dx = std::abs(_to.x - x);
+    const int dy = std::abs(_to.y - y);
+    
+    // Walks every cell the segment enters, the error tells which side of 
+    // the segment the next cell corner lies on
+    int error = dx - dy;
+    
+    for (int remaining = dx + dy; remaining > 0; --remaining)
+    {
+        if (error > 0)
+        {
+            x += step_x;
+            error -= 2 * dy;
+        }
+        else if (error < 0)
+        {
+            y += step_y;
+            error += 2 * dx;
+        }
+        else
+        {
+            if (!_diagonal && (_walls.is_blocked(x + step_x, y) || _walls.is_blocked(x, y + step_y)))
+                return false;
+            
+            x += step_x;
+            y += step_y;
+            error += 2 * (dx - dy);
+            --remaining;
+        }
+        
+        if (_walls.is_blocked(x, y))
+            return false;
+    }
+    
+    return true;
+}
+
+vector2_array_i pull_string(const occupancy_grid& _walls, const vector2_array_i& _path, bool _diagonal)
+{
+    if (_path.size() <= 2)
+        return _path;
+    
+    vector2_array_i result;
+    std::size_t anchor = 0;
+    
+    result.push_back(_path.front());
+    
+    for (std::size_t i = 2; i < _path.size(); ++i)
+    {
+        if (has_line_of_sight(_walls, _path[anchor], _path[i], _diagonal))
+            continue;
+        
+        anchor = i - 1;
+        result.push_back(_path[anchor]);
+    }
+    
+    result.push_back(_path.back());
+    
+    return result;
+}
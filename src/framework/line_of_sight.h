@@ -0,0 +1,39 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LINE_OF_SIGHT_H
+#define LINE_OF_SIGHT_H
+
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+// Whether the segment between the centers of two cells crosses only free 
+// cells.  A segment through the exact corner of four cells needs the 
+// diagonal cell free, and the two side cells too without diagonal movement.
+bool has_line_of_sight(const occupancy_grid& _walls, vector2_i _from, vector2_i _to, bool _diagonal);
+
+// Keeps the first and last cells of _path and each cell where a straight 
+// line from the previous kept cell would stop seeing the next one
+vector2_array_i pull_string(const occupancy_grid& _walls, const vector2_array_i& _path, bool _diagonal);
+
+#endif /* LINE_OF_SIGHT_H */
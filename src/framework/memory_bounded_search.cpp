@@ -0,0 +1,361 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "memory_bounded_search.h"
+#include <algorithm>
+#include <cstdlib>
+#include <framework/search_grid.h>
+
+namespace
+{
+    // Larger than any path cost, small enough to add a step to
+    const int32_t infinite_cost = INT32_MAX / 2;
+    
+    inline int32_t step_cost(int _direction)
+    {
+        return (_direction < 4 ? 10 : 14);
+    }
+}
+
+const uint64_t memory_bounded_search::empty_cell;
+const uint32_t memory_bounded_search::last_iteration;
+const std::size_t memory_bounded_search::ways;
+const int memory_bounded_search::cut_buckets;
+const int32_t memory_bounded_search::cut_width;
+
+memory_bounded_search::memory_bounded_search(const occupancy_grid& _walls) :
+      walls(_walls)
+    , node_limit(65536)
+    , expansion_limit(0)
+    , check_expansions(0)
+    , expansions(0)
+    , iterations(0)
+    , iteration(0)
+    , first_iteration(1)
+    , width(0)
+    , overflowed(false)
+{}
+
+void memory_bounded_search::set_node_limit(std::size_t _nodes)
+{
+    node_limit = std::max<std::size_t>(1, _nodes);
+    table.clear();
+    table.shrink_to_fit();
+}
+
+vector2_array_i memory_bounded_search::find_path(
+      vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic)
+{
+    expansions = 0;
+    iterations = 0;
+    
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return {};
+    
+    if (_start == static_cast<vector2_i>(_goal))
+        return { _start };
+    
+    if (table.empty())
+        clear_table();
+    
+    width = walls.get_size().x;
+    
+    const int directions = (_diagonal ? 8 : 4);
+    const vector2_i size = walls.get_size();
+    
+    // No path without a repeated cell costs more than a diagonal step per 
+    // free cell, so no threshold past that finds one
+    const int64_t free_cells = static_cast<int64_t>(size.x) * size.y - static_cast<int64_t>(walls.get_blocked_count());
+    const int32_t cost_limit = static_cast<int32_t>(std::min<int64_t>(infinite_cost, free_cells * step_cost(4)));
+    
+    const uint64_t start_id = static_cast<uint64_t>(_start.y) * width + _start.x;
+    const uint64_t goal_id = static_cast<uint64_t>(_goal.y) * width + _goal.x;
+    
+    // Learned costs of older queries lead to another goal
+    first_iteration = iteration + 1;
+    overflowed = false;
+    
+    int32_t lower = _heuristic(_start, _goal);  // no path costs less
+    int32_t threshold = lower;
+    vector2_array_i path;
+    
+    for (;;)
+    {
+        if (iteration == last_iteration)
+        {
+            clear_table();
+            first_iteration = 1;
+        }
+        
+        ++iteration;
+        ++iterations;
+        
+        int32_t next_threshold = infinite_cost;
+        int32_t best = infinite_cost;
+        std::size_t searched = 0;
+        std::size_t unsearched = 0;     // cut cells no path reached within the threshold yet
+        std::fill(cut_counts, cut_counts + cut_buckets, 0);
+        
+        entry* root = find(start_id);
+        
+        if (!root)
+            root = &claim(start_id, _heuristic(_start, _goal));
+        
+        root->iteration = iteration;
+        root->g = 0;
+        
+        stack.clear();
+        stack.push_back({ start_id, 0, root->h, infinite_cost, 0, search_grid::no_parent });
+        ++expansions;
+        
+        while (!stack.empty())
+        {
+            frame& top = stack.back();
+            
+            // Every child is searched, so the cell needs at least the 
+            // cheapest cost to the goal through them
+            if (top.next == directions)
+            {
+                const int32_t learned = std::max(top.h, top.backup);
+                const uint8_t parent = top.parent;
+                
+                learn(top.cell, learned);
+                stack.pop_back();
+                
+                if (!stack.empty())
+                    stack.back().backup = std::min(stack.back().backup, learned + step_cost(parent));
+                
+                continue;
+            }
+            
+            const int i = top.next++;
+            const int nx = static_cast<int>(top.cell % width) + grid_direction_x[i];
+            const int ny = static_cast<int>(top.cell / width) + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            const uint64_t id = static_cast<uint64_t>(ny) * width + nx;
+            const int32_t g = top.g + step_cost(i);
+            
+            if (id == goal_id && g <= threshold)
+            {
+                path.clear();
+                path.push_back(_goal);
+                
+                for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+                    path.push_back({ static_cast<int>(it->cell % width), static_cast<int>(it->cell / width) });
+                
+                if (g <= lower)
+                    return path;
+                
+                // The threshold overshot the lower bound, so the rest of the 
+                // iteration looks for cheaper paths only
+                best = g;
+                threshold = g - 1;
+                top.backup = std::min(top.backup, step_cost(i));
+                continue;
+            }
+            
+            entry* item = find(id);
+            const int32_t h = (item ? item->h : _heuristic({ nx, ny }, _goal));
+            
+            if (g + h > threshold)
+            {
+                top.backup = std::min(top.backup, step_cost(i) + h);
+                
+                // Already searched from a path as cheap in this iteration
+                if (item && item->iteration == iteration && item->g <= g)
+                    continue;
+                
+                next_threshold = std::min(next_threshold, g + h);
+                ++cut_counts[std::min<int32_t>(cut_buckets - 1, (g + h - threshold - 1) / cut_width)];
+                
+                // Marked with no g until a path reaches it within the threshold
+                if (!overflowed && (!item || item->iteration != iteration))
+                {
+                    if (!item)
+                        item = &claim(id, h);
+                    
+                    item->iteration = iteration;
+                    item->g = infinite_cost;
+                    ++unsearched;
+                }
+                
+                continue;
+            }
+            
+            // Without room for every cell, the table no longer catches 
+            // the many equally cheap orders of the same moves
+            if (overflowed && is_redundant(top, i, directions))
+            {
+                top.backup = std::min(top.backup, step_cost(i) + h);
+                continue;
+            }
+            
+            // Reached at no lower cost earlier in this iteration, or a 
+            // cycle back to a cell of the current path
+            if (item && item->iteration == iteration && item->g <= g)
+            {
+                top.backup = std::min(top.backup, step_cost(i) + h);
+                continue;
+            }
+            
+            if (!item)
+                item = &claim(id, h);
+            else if (item->iteration == iteration && item->g == infinite_cost)
+                --unsearched;
+            
+            item->iteration = iteration;
+            item->g = g;
+            
+            stack.push_back({ id, g, h, infinite_cost, 0, static_cast<uint8_t>(i) });
+            ++expansions;
+            ++searched;
+            
+            if (expansions == expansion_limit)
+                return {};
+            
+            if (expansions == check_expansions && unreachable_check && unreachable_check())
+                return {};
+        }
+        
+        if (best < infinite_cost)
+            return path;
+        
+        // Every cell a cut led to was searched, so the cells of this 
+        // iteration are all the goal could be reached through.  A table 
+        // that forgot cells cannot tell, but the cost limit still ends it.
+        if (next_threshold >= infinite_cost || next_threshold > cost_limit || (unsearched == 0 && !overflowed))
+            return {};
+        
+        // Raising the threshold to the smallest f cut takes one iteration 
+        // per distinct f, hundreds in a maze.  Raising it far enough to 
+        // about double the cells searched keeps the iterations few.
+        lower = next_threshold;
+        
+        std::size_t count = 0;
+        int bucket = 0;
+        
+        for (int b = 0; b < cut_buckets && count < searched; ++b)
+        {
+            if (cut_counts[b] != 0)
+                bucket = b;
+            
+            count += cut_counts[b];
+        }
+        
+        threshold = std::max(next_threshold, threshold + (bucket + 1) * cut_width);
+    }
+}
+
+bool memory_bounded_search::is_redundant(const frame& _frame, int _direction, int _directions) const
+{
+    if (_frame.parent == search_grid::no_parent)
+        return false;
+    
+    // Offset of the child from the cell before _frame
+    const int dx = grid_direction_x[_frame.parent] + grid_direction_x[_direction];
+    const int dy = grid_direction_y[_frame.parent] + grid_direction_y[_direction];
+    
+    if (dx == 0 && dy == 0)
+        return true;
+    
+    if (_directions == 8)
+    {
+        // One move from the cell before reaches it for less
+        if (std::abs(dx) <= 1 && std::abs(dy) <= 1)
+            return true;
+        
+        // Two straight moves through the free cell between reach it for less
+        if (_frame.parent >= 4 && _direction >= 4 && (dx == 0 || dy == 0))
+            return !walls.is_blocked(static_cast<int>(_frame.cell % width) - grid_direction_x[_frame.parent] + dx / 2, 
+                static_cast<int>(_frame.cell / width) - grid_direction_y[_frame.parent] + dy / 2);
+        
+        if (_frame.parent >= 4 || _direction < 4)
+            return false;
+    }
+    else if (grid_direction_y[_frame.parent] != 0 || grid_direction_y[_direction] == 0)
+    {
+        return false;
+    }
+    
+    // Same moves in the other order, through a free cell
+    const int x = static_cast<int>(_frame.cell % width) - grid_direction_x[_frame.parent];
+    const int y = static_cast<int>(_frame.cell / width) - grid_direction_y[_frame.parent];
+    
+    return !walls.is_blocked(x + grid_direction_x[_direction], y + grid_direction_y[_direction]);
+}
+
+memory_bounded_search::entry* memory_bounded_search::find(uint64_t _cell)
+{
+    entry* first = &table[bucket(_cell)];
+    
+    for (std::size_t i = 0; i < ways; ++i)
+        if (first[i].cell == _cell && first[i].iteration >= first_iteration)
+            return &first[i];
+    
+    return nullptr;
+}
+
+memory_bounded_search::entry& memory_bounded_search::claim(uint64_t _cell, int32_t _h)
+{
+    entry* first = &table[bucket(_cell)];
+    entry* victim = first;
+    
+    // Cells of older iterations only keep their learned h, and the cells 
+    // nearest the start cut the largest subtrees
+    for (std::size_t i = 0; i < ways && victim->iteration >= first_iteration; ++i)
+    {
+        if (first[i].iteration < victim->iteration 
+            || (first[i].iteration == victim->iteration && first[i].g > victim->g))
+            victim = &first[i];
+    }
+    
+    // Losing a cell marked as cut only costs the proof of an unreachable goal
+    if (victim->iteration == iteration && victim->g != infinite_cost)
+        overflowed = true;
+    
+    victim->cell = _cell;
+    victim->h = _h;
+    
+    return *victim;
+}
+
+void memory_bounded_search::clear_table()
+{
+    table.assign(std::max(ways, node_limit / ways * ways), { empty_cell, 0, 0, 0 });
+    iteration = 0;
+}
+
+void memory_bounded_search::learn(uint64_t _cell, int32_t _h)
+{
+    entry* item = find(_cell);
+    
+    // Forgotten when another cell took the entry
+    if (item)
+        item->h = std::max(item->h, _h);
+}
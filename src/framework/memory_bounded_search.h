@@ -0,0 +1,169 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MEMORY_BOUNDED_SEARCH_H
+#define MEMORY_BOUNDED_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Iterative deepening A* (IDA*) with a fixed-size transposition table.
+ * 
+ * Each iteration is a depth-first search that stops at cells whose f 
+ * exceeds a threshold.  The next iteration raises the threshold past the 
+ * smallest f it stopped at, far enough to search about twice the cells.  
+ * Once a path turns up, the iteration lowers the threshold below its cost 
+ * and keeps looking for a cheaper one, so the path it returns is optimal.
+ * 
+ * The table holds at most the node limit of cells.  It remembers the 
+ * cheapest g of each cell in the current iteration, to cut paths that reach 
+ * a cell again at no lower cost, and the cost to the goal each searched 
+ * cell was found to need, which raises its h in later iterations.  When a 
+ * bucket of the table is full, a new cell replaces the one from the oldest 
+ * iteration, then the one farthest from the start, and the search 
+ * re-expands what it forgot instead of allocating.  From the first such 
+ * overflow on, it also skips the moves jump point search prunes, which only 
+ * reach cells some path as cheap reaches too.  Memory is the table plus the 
+ * stack of the current path.
+ * 
+ * An iteration whose cuts all led to cells it searched anyway has searched 
+ * every cell the start reaches, so a goal it did not find is unreachable.  
+ * After an overflow the table cannot tell, and the search gives up once the 
+ * threshold passes the cost of a path through every free cell instead.
+ */
+class memory_bounded_search
+{
+    
+public:
+    
+    explicit memory_bounded_search(const occupancy_grid& _walls);
+    
+    // Cells the transposition table holds, 65536 by default.  The table is 
+    // allocated by the next search.
+    void set_node_limit(std::size_t _nodes);
+    inline std::size_t get_node_limit() const { return node_limit; }
+    
+    // Expansions after which find_path gives up and returns no path, 0 (no 
+    // limit) by default.  Bounds the search for an unreachable goal in a 
+    // world too large to search through.
+    inline void set_expansion_limit(std::size_t _expansions) { expansion_limit = _expansions; }
+    
+    // Asked once a search reaches _expansions, 0 (never) by default, whether 
+    // the goal is unreachable after all, so that checks too slow for every 
+    // query only run for the long ones.  find_path returns no path on true.
+    inline void set_unreachable_check(std::size_t _expansions, std::function<bool()> _check)
+    {
+        check_expansions = _expansions;
+        unreachable_check = std::move(_check);
+    }
+    
+    // Path from _goal back to _start, empty if the goal is unreachable
+    vector2_array_i find_path(
+          vector2_i _start
+        , vector2_i _goal
+        , bool _diagonal
+        , const std::function<int(vector2_i, vector2_i)>& _heuristic);
+    
+    // Cells expanded by the last call to find_path, counting every re-expansion
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    // Thresholds tried by the last call to find_path
+    inline std::size_t get_iterations() const { return iterations; }
+    
+    // Bytes of the transposition table and the deepest stack of the last search
+    inline std::size_t get_memory_usage() const 
+    { 
+        return table.size() * sizeof(entry) + stack.capacity() * sizeof(frame); 
+    }
+    
+private:
+    
+    static const uint64_t empty_cell = (uint64_t(1) << 40) - 1;
+    static const uint32_t last_iteration = (uint32_t(1) << 24) - 1;
+    static const std::size_t ways = 4;      // entries per bucket
+    static const int cut_buckets = 128;
+    static const int32_t cut_width = 2;     // f range of each bucket of cut_counts
+    
+    struct entry
+    {
+        uint64_t cell : 40;         // row-major, for worlds of up to 2^40 cells
+        uint64_t iteration : 24;    // iteration g belongs to
+        int32_t g;                  // cheapest cost from the start in that iteration
+        int32_t h;                  // learned cost to the goal, at least the heuristic
+    };
+    
+    struct frame
+    {
+        uint64_t cell;
+        int32_t g;
+        int32_t h;
+        int32_t backup;         // smallest cost to the goal through the children seen so far
+        uint8_t next;           // next direction to try
+        uint8_t parent;         // direction the cell was reached from
+    };
+    
+    const occupancy_grid& walls;
+    std::vector<entry> table;
+    std::size_t node_limit;
+    std::size_t expansion_limit;
+    std::size_t check_expansions;
+    std::function<bool()> unreachable_check;
+    std::vector<frame> stack;
+    std::size_t cut_counts[cut_buckets];    // cells cut by the last iteration, on f over the threshold
+    std::size_t expansions;
+    std::size_t iterations;
+    uint32_t iteration;
+    uint32_t first_iteration;                                   // first iteration of the current query
+    int width;
+    bool overflowed;                                            // a cell of this iteration was replaced
+    
+    // First entry of the bucket of _cell
+    inline std::size_t bucket(uint64_t _cell) const
+    {
+        return static_cast<std::size_t>((_cell * UINT64_C(0x9E3779B97F4A7C15)) >> 32) % (table.size() / ways) * ways;
+    }
+    
+    // Entry _cell has in the current query, nullptr when the table forgot it
+    entry* find(uint64_t _cell);
+    
+    // Entry for _cell, taking the least useful one of its bucket
+    entry& claim(uint64_t _cell, int32_t _h);
+    
+    void learn(uint64_t _cell, int32_t _h);
+    
+    // Whether some path as cheap reaches the child of _frame in _direction 
+    // without this move, so searching from it would only repeat work
+    bool is_redundant(const frame& _frame, int _direction, int _directions) const;
+    
+    // Empties the table at the node limit and restarts the iteration count
+    void clear_table();
+    
+};
+
+#endif /* MEMORY_BOUNDED_SEARCH_H */
@@ -0,0 +1,337 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "moving_ai_loader.h"
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    // Read-only mapping of a whole file, empty when the file cannot be mapped
+    class mapped_file
+    {
+        
+    public:
+        
+        explicit mapped_file(const std::string& _path) : begin(nullptr), end(nullptr)
+        {
+            int file = open(_path.c_str(), O_RDONLY);
+            
+            if (file < 0)
+                return;
+            
+            struct stat info;
+            
+            if (fstat(file, &info) == 0 && info.st_size > 0)
+            {
+                const std::size_t size = static_cast<std::size_t>(info.st_size);
+                void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+                
+                if (mapping != MAP_FAILED)
+                {
+                    madvise(mapping, size, MADV_SEQUENTIAL);
+                    begin = static_cast<const char*>(mapping);
+                    end = begin + size;
+                }
+            }
+            
+            // The mapping outlives the descriptor
+            close(file);
+        }
+        
+        ~mapped_file()
+        {
+            if (begin)
+                munmap(const_cast<char*>(begin), static_cast<std::size_t>(end - begin));
+        }
+        
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+        
+        const char* begin;
+        const char* end;
+        
+    };
+    
+    inline bool is_digit(char _c)
+    {
+        return (_c >= '0' && _c <= '9');
+    }
+    
+    inline bool is_line_end(char _c)
+    {
+        return (_c == '\n' || _c == '\r');
+    }
+    
+    // Spaces and tabs, not line ends
+    inline void skip_blanks(const char*& _p, const char* _end)
+    {
+        while (_p < _end && (*_p == ' ' || *_p == '\t'))
+            ++_p;
+    }
+    
+    // Past the end of the current line
+    inline void skip_line(const char*& _p, const char* _end)
+    {
+        while (_p < _end && *_p != '\n')
+            ++_p;
+        
+        if (_p < _end)
+            ++_p;
+    }
+    
+    // Characters up to the next blank or line end, false when there are none
+    bool read_word(const char*& _p, const char* _end, const char*& _word, std::size_t& _length)
+    {
+        skip_blanks(_p, _end);
+        _word = _p;
+        
+        while (_p < _end && *_p != ' ' && *_p != '\t' && !is_line_end(*_p))
+            ++_p;
+        
+        _length = static_cast<std::size_t>(_p - _word);
+        
+        return (_length != 0);
+    }
+    
+    inline bool is_blocked_cell(char _c)
+    {
+        return (_c != '.' && _c != 'G' && _c != 'S');
+    }
+    
+    inline bool is_word(const char* _word, std::size_t _length, const char* _expected)
+    {
+        return (_length == std::strlen(_expected) && std::memcmp(_word, _expected, _length) == 0);
+    }
+    
+    bool read_int(const char*& _p, const char* _end, int& _value)
+    {
+        skip_blanks(_p, _end);
+        
+        const bool negative = (_p < _end && *_p == '-');
+        
+        if (negative)
+            ++_p;
+        
+        if (_p == _end || !is_digit(*_p))
+            return false;
+        
+        // Magnitude of INT_MIN for negative numbers
+        const unsigned limit = static_cast<unsigned>(INT_MAX) + (negative ? 1u : 0u);
+        unsigned value = 0;
+        
+        while (_p < _end && is_digit(*_p))
+        {
+            const unsigned digit = static_cast<unsigned>(*_p++ - '0');
+            
+            if (value > (limit - digit) / 10)
+                return false;
+            
+            value = value * 10 + digit;
+        }
+        
+        _value = (negative ? static_cast<int>(0u - value) : static_cast<int>(value));
+        
+        return true;
+    }
+    
+    // Decimal number with an optional fraction and exponent
+    bool read_length(const char*& _p, const char* _end, double& _value)
+    {
+        skip_blanks(_p, _end);
+        
+        const char* first = _p;
+        double value = 0.0;
+        
+        while (_p < _end && is_digit(*_p))
+            value = value * 10.0 + (*_p++ - '0');
+        
+        if (_p < _end && *_p == '.')
+        {
+            double scale = 0.1;
+            
+            for (++_p; _p < _end && is_digit(*_p); scale *= 0.1)
+                value += (*_p++ - '0') * scale;
+        }
+        
+        if (_p == first)
+            return false;
+        
+        if (_p < _end && (*_p == 'e' || *_p == 'E'))
+        {
+            ++_p;
+            
+            if (_p < _end && *_p == '+')
+                ++_p;
+            
+            int exponent = 0;
+            
+            if (!read_int(_p, _end, exponent))
+                return false;
+            
+            value *= std::pow(10.0, exponent);
+        }
+        
+        _value = value;
+        
+        return true;
+    }
+}
+
+bool read_map_file(const std::string& _path, occupancy_grid& _walls)
+{
+    _walls.resize({ 0, 0 });
+    
+    mapped_file file(_path);
+    
+    if (!file.begin)
+        return false;
+    
+    const char* p = file.begin;
+    const char* end = file.end;
+    int width = 0;
+    int height = 0;
+    
+    // "type", "height" and "width" lines in any order, up to "map"
+    for (;;)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || is_line_end(*p)))
+            ++p;
+        
+        const char* word;
+        std::size_t length;
+        
+        if (!read_word(p, end, word, length))
+            return false;
+        
+        if (is_word(word, length, "map"))
+        {
+            skip_line(p, end);
+            break;
+        }
+        
+        if (is_word(word, length, "height") && !read_int(p, end, height))
+            return false;
+        
+        if (is_word(word, length, "width") && !read_int(p, end, width))
+            return false;
+        
+        skip_line(p, end);
+    }
+    
+    if (width <= 0 || height <= 0 
+        || static_cast<std::size_t>(end - p) < static_cast<std::size_t>(width) * height)
+        return false;
+    
+    _walls.resize({ width, height });
+    
+    for (int y = 0; y < height; ++y)
+    {
+        // Missing or short rows
+        if (end - p < width || std::memchr(p, '\n', static_cast<std::size_t>(width)))
+        {
+            _walls.resize({ 0, 0 });
+            return false;
+        }
+        
+        _walls.set_row(y, p, is_blocked_cell);
+        p += width;
+        
+        if (p < end && *p == '\r')
+            ++p;
+        
+        if (p < end && *p == '\n')
+            ++p;
+    }
+    
+    return true;
+}
+
+bool read_scenario_file(const std::string& _path, std::vector<scenario>& _scenarios, std::string& _map)
+{
+    mapped_file file(_path);
+    
+    if (!file.begin)
+        return false;
+    
+    const char* p = file.begin;
+    const char* end = file.end;
+    bool first = true;
+    
+    // Kept apart until the whole file parses
+    std::vector<scenario> entries;
+    std::string first_map;
+    
+    while (p < end)
+    {
+        skip_blanks(p, end);
+        
+        if (p == end)
+            break;
+        
+        // Blank lines and the "version" line
+        if (is_line_end(*p) || *p == 'v')
+        {
+            skip_line(p, end);
+            continue;
+        }
+        
+        scenario entry;
+        const char* map;
+        std::size_t length;
+        int map_width;
+        int map_height;
+        
+        if (!read_int(p, end, entry.bucket) 
+            || !read_word(p, end, map, length)
+            || !read_int(p, end, map_width)
+            || !read_int(p, end, map_height)
+            || !read_int(p, end, entry.start.x)
+            || !read_int(p, end, entry.start.y)
+            || !read_int(p, end, entry.goal.x)
+            || !read_int(p, end, entry.goal.y)
+            || !read_length(p, end, entry.optimal_length))
+            return false;
+        
+        if (first)
+        {
+            first_map.assign(map, length);
+            first = false;
+        }
+        
+        entries.push_back(entry);
+        skip_line(p, end);
+    }
+    
+    _scenarios.insert(_scenarios.end(), entries.begin(), entries.end());
+    
+    if (!first)
+        _map.swap(first_map);
+    
+    return true;
+}
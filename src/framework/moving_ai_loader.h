@@ -0,0 +1,56 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MOVING_AI_LOADER_H
+#define MOVING_AI_LOADER_H
+
+#include <string>
+#include <vector>
+#include <framework/occupancy_grid.h>
+#include <math/linear_algebra/vector.h>
+
+// One query of a MovingAI .scen file
+struct scenario
+{
+    int bucket;
+    vector2_i start;
+    vector2_i goal;
+    double optimal_length;      // diagonals count sqrt(2), corners cannot be cut
+};
+
+// Replaces the size and collisions of _walls with those of the MovingAI 
+// .map file at _path, detaching any tiles.  The file is memory-mapped and 
+// its rows are read straight into the grid.  '.', 'G' and 'S' are free 
+// and every other cell is blocked.  False, with an empty world, when the 
+// file is not a map.
+bool read_map_file(const std::string& _path, occupancy_grid& _walls);
+
+// Appends the queries of the MovingAI .scen file at _path to _scenarios 
+// and sets _map to the map of its first query.  Lengths assume the 
+// diagonal moves of the benchmarks, which never cut a corner, so 
+// path_builder may find 8-connected paths shorter than them.  False, with 
+// _scenarios and _map untouched, when the file cannot be read, a line is 
+// not a query or a number does not fit in an int.
+bool read_scenario_file(const std::string& _path, std::vector<scenario>& _scenarios, std::string& _map);
+
+#endif /* MOVING_AI_LOADER_H */
@@ -56,7 +56,7 @@ struct node
     inline double get_sum() { return g + h; } // calculates sum of g + h
     
     inline node_state get_state() { return state; }
-    inline node_state set_state(node_state _state) { state = _state; }
+    inline void set_state(node_state _state) { state = _state; }
     
     bool operator==(const node& A)
     {
@@ -0,0 +1,121 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <type_traits>
+#include <framework/node.h>
+#include <core/interface.h>
+
+/*
+ * Bump allocator for the nodes of one search.
+ * 
+ * Nodes are carved out of fixed-size chunks.  release() rewinds to the 
+ * first chunk in one step and keeps every chunk, so once the pool has grown
+ * to the size of the largest query, searches stop allocating.
+ */
+class node_pool : private non_copyable
+{
+    
+public:
+    
+    static_assert(std::is_trivially_destructible<node>::value, 
+        "node_pool never runs destructors");
+    
+    explicit node_pool(std::size_t _chunk_size = 4096) :
+          chunk_size(_chunk_size)
+        , chunk(0)
+        , used(0)
+    {}
+    
+    ~node_pool()
+    {
+        for (auto storage : chunks)
+            ::operator delete(storage);
+    }
+    
+    inline node* create(
+          vector2_i _position
+        , node* _parent = nullptr
+        , node_state _state = node_state::NONE)
+    {
+        if (chunk == chunks.size() || used == chunk_size)
+            next_chunk();
+        
+        return new (chunks[chunk] + used++) node(_position, _parent, _state);
+    }
+    
+    // Forgets every node at once, keeping the chunks for the next search
+    inline void release()
+    {
+        chunk = 0;
+        used = 0;
+    }
+    
+    // Number of live nodes
+    inline std::size_t size() const 
+    { 
+        return (chunks.empty() ? 0 : chunk * chunk_size + used); 
+    }
+    
+    // Number of nodes that fit without allocating
+    inline std::size_t capacity() const { return chunks.size() * chunk_size; }
+    
+    template<class F>
+    void for_each(F _function)
+    {
+        for (std::size_t i = 0; i < chunks.size() && i <= chunk; ++i)
+        {
+            std::size_t count = (i < chunk ? chunk_size : used);
+            
+            for (std::size_t j = 0; j < count; ++j)
+                _function(chunks[i] + j);
+        }
+    }
+    
+private:
+    
+    const std::size_t chunk_size;
+    std::vector<node*> chunks;
+    std::size_t chunk;  // chunk being filled
+    std::size_t used;   // nodes handed out from that chunk
+    
+    void next_chunk()
+    {
+        if (used == chunk_size)
+        {
+            ++chunk;
+            used = 0;
+        }
+        
+        if (chunk == chunks.size())
+            chunks.push_back(static_cast<node*>(::operator new(chunk_size * sizeof(node))));
+    }
+    
+};
+
+#endif /* NODE_POOL_H */
@@ -0,0 +1,284 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <vector>
+#include <framework/tiled_grid.h>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * World-sized bitmap of blocked cells, one bit per cell in row-major order.
+ * 
+ * Adding, removing and testing a cell are O(1).  Cells outside the world 
+ * read as blocked and cannot be written, so callers need no bounds checks.
+ * A 4096 x 4096 world takes 2 MB.  Attached to a tiled grid, it reads and 
+ * writes the tiles of the grid instead, for worlds too large for memory.
+ */
+class occupancy_grid
+{
+    
+public:
+    
+    explicit occupancy_grid() : width(0), height(0), blocked(0), tiles(nullptr) {}
+    
+    inline vector2_i get_size() const 
+    { 
+        return (tiles ? tiles->get_size() : vector2_i({ width, height })); 
+    }
+    
+    inline bool is_tiled() const { return tiles != nullptr; }
+    
+    inline std::size_t get_blocked_count() const 
+    { 
+        return (tiles ? tiles->get_blocked_count() : blocked); 
+    }
+    
+    inline std::size_t get_memory_usage() const 
+    { 
+        return (tiles ? tiles->get_memory_usage() : words.size() * sizeof(uint64_t)); 
+    }
+    
+    inline bool is_inside(vector2_i _coordinates) const
+    {
+        const vector2_i size = get_size();
+        
+        return (static_cast<unsigned>(_coordinates.x) < static_cast<unsigned>(size.x)
+             && static_cast<unsigned>(_coordinates.y) < static_cast<unsigned>(size.y));
+    }
+    
+    inline bool is_blocked(vector2_i _coordinates) const
+    {
+        return is_blocked(_coordinates.x, _coordinates.y);
+    }
+    
+    inline bool is_blocked(int _x, int _y) const
+    {
+        if (static_cast<unsigned>(_x) >= static_cast<unsigned>(width) 
+         || static_cast<unsigned>(_y) >= static_cast<unsigned>(height))
+            return (!tiles || !is_inside({ _x, _y }) || tiles->is_blocked(_x, _y));
+        
+        std::size_t bit = static_cast<std::size_t>(_y) * width + _x;
+        return ((words[bit >> 6] >> (bit & 63)) & 1) != 0;
+    }
+    
+    // Cells _x - 1, _x and _x + 1 of row _y in bits 0, 1 and 2, set when blocked
+    inline uint32_t get_row_triple(int _x, int _y) const
+    {
+        if (static_cast<unsigned>(_y) >= static_cast<unsigned>(height))
+            return (tiles ? get_tiled_row_triple(_x, _y) : 0x7);
+        
+        if (_x < 1 || _x + 1 >= width)
+        {
+            return static_cast<uint32_t>(is_blocked(_x - 1, _y)) 
+                | (static_cast<uint32_t>(is_blocked(_x, _y)) << 1) 
+                | (static_cast<uint32_t>(is_blocked(_x + 1, _y)) << 2);
+        }
+        
+        std::size_t bit = static_cast<std::size_t>(_y) * width + _x - 1;
+        std::size_t offset = bit & 63;
+        uint64_t value = words[bit >> 6] >> offset;
+        
+        // The three cells straddle two words
+        if (offset > 61)
+            value |= words[(bit >> 6) + 1] << (64 - offset);
+        
+        return static_cast<uint32_t>(value & 0x7);
+    }
+    
+    // Returns whether the cell changed, so false when it was blocked already 
+    // or lies outside the world
+    inline bool set(vector2_i _coordinates)
+    {
+        if (!is_inside(_coordinates))
+            return false;
+        
+        if (tiles)
+            return tiles->set(_coordinates.x, _coordinates.y);
+        
+        std::size_t bit = index(_coordinates);
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        
+        if (words[bit >> 6] & mask)
+            return false;
+        
+        words[bit >> 6] |= mask;
+        ++blocked;
+        
+        return true;
+    }
+    
+    // Returns whether the cell changed, so false when it was free already 
+    // or lies outside the world
+    inline bool reset(vector2_i _coordinates)
+    {
+        if (!is_inside(_coordinates))
+            return false;
+        
+        if (tiles)
+            return tiles->reset(_coordinates.x, _coordinates.y);
+        
+        std::size_t bit = index(_coordinates);
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        
+        if (!(words[bit >> 6] & mask))
+            return false;
+        
+        words[bit >> 6] &= ~mask;
+        --blocked;
+        
+        return true;
+    }
+    
+    // Blocks the cells of row _y whose byte of _cells _blocked returns true 
+    // for, a word of the bitmap at a time.  Does nothing when attached.
+    template<class predicate>
+    void set_row(int _y, const char* _cells, predicate _blocked)
+    {
+        if (static_cast<unsigned>(_y) >= static_cast<unsigned>(height))
+            return;
+        
+        std::size_t bit = static_cast<std::size_t>(_y) * width;
+        uint64_t bits = 0;
+        
+        for (int x = 0; x < width; ++x)
+        {
+            bits |= static_cast<uint64_t>(_blocked(_cells[x])) << (bit & 63);
+            
+            if ((++bit & 63) == 0)
+            {
+                merge_word((bit >> 6) - 1, bits);
+                bits = 0;
+            }
+        }
+        
+        if (bit & 63)
+            merge_word(bit >> 6, bits);
+    }
+    
+    // Frees every cell, in the tiles too when attached
+    void clear()
+    {
+        if (tiles)
+            tiles->clear();
+        
+        std::fill(words.begin(), words.end(), 0);
+        blocked = 0;
+    }
+    
+    // Keeps the blocked cells that are still inside the new size.  A new 
+    // size detaches the tiles first and keeps none of their cells.
+    void resize(vector2_i _size)
+    {
+        const vector2_i size = get_size();
+        
+        if (_size.x == size.x && _size.y == size.y)
+            return;
+        
+        detach();
+        
+        occupancy_grid resized;
+        resized.width = (_size.x > 0 ? _size.x : 0);
+        resized.height = (_size.y > 0 ? _size.y : 0);
+        resized.words.assign((static_cast<std::size_t>(resized.width) * resized.height + 63) / 64, 0);
+        
+        for (int y = 0; y < height && y < resized.height; ++y)
+            for (int x = 0; x < width && x < resized.width; ++x)
+                if (is_blocked({ x, y }))
+                    resized.set({ x, y });
+        
+        *this = std::move(resized);
+    }
+    
+    // Reads and writes the cells of _tiles, which must stay open until the 
+    // grid detaches, in place of its own bitmap
+    void attach(tiled_grid& _tiles)
+    {
+        words.clear();
+        words.shrink_to_fit();
+        width = 0;
+        height = 0;
+        blocked = 0;
+        tiles = &_tiles;
+    }
+    
+    // Leaves an empty world of no cells when attached
+    void detach()
+    {
+        tiles = nullptr;
+    }
+    
+private:
+    
+    int width;
+    int height;
+    std::size_t blocked;
+    std::vector<uint64_t> words;
+    
+    // Attached, width and height stay 0 so that every cell takes the branch 
+    // for cells outside the world, which keeps the tiles off the path of 
+    // the bitmap
+    tiled_grid* tiles;
+    
+    inline std::size_t index(vector2_i _coordinates) const
+    {
+        return static_cast<std::size_t>(_coordinates.y) * width + _coordinates.x;
+    }
+    
+    // Sets _bits in word _word and counts the cells that were free
+    inline void merge_word(std::size_t _word, uint64_t _bits)
+    {
+        uint64_t added = _bits & ~words[_word];
+        words[_word] |= _bits;
+        
+        added = added - ((added >> 1) & UINT64_C(0x5555555555555555));
+        added = (added & UINT64_C(0x3333333333333333)) + ((added >> 2) & UINT64_C(0x3333333333333333));
+        added = (added + (added >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+        blocked += static_cast<std::size_t>((added * UINT64_C(0x0101010101010101)) >> 56);
+    }
+    
+    uint32_t get_tiled_row_triple(int _x, int _y) const
+    {
+        const vector2_i size = tiles->get_size();
+        
+        if (static_cast<unsigned>(_y) >= static_cast<unsigned>(size.y))
+            return 0x7;
+        
+        if (_x < 1 || _x + 1 >= size.x)
+        {
+            return static_cast<uint32_t>(is_blocked(_x - 1, _y)) 
+                | (static_cast<uint32_t>(is_blocked(_x, _y)) << 1) 
+                | (static_cast<uint32_t>(is_blocked(_x + 1, _y)) << 2);
+        }
+        
+        return tiles->get_row_triple(_x, _y);
+    }
+    
+};
+
+#endif /* OCCUPANCY_GRID_H */
@@ -31,22 +31,77 @@
 #include <set>
 #include <math.h>
 #include <cstring>
+#include <limits>
 #include <random>
+#include <atomic>
+#include <future>
 #include <core/exception.h>
 #include <math/common.h>
 #include <framework/actor.h>
+#include <parallel/thread_pool.h>
 
-path_builder::path_builder()
+// Search state owned by one task of find_paths
+struct path_builder::batch_worker
+{
+    astar_search astar;
+    jump_point_search jump_points;
+    bidirectional_search bidirectional;
+    fringe_search fringe;
+    std::size_t expansions;
+    
+    explicit batch_worker(const occupancy_grid& _walls) :
+          astar(_walls)
+        , jump_points(_walls)
+        , bidirectional(_walls)
+        , fringe(_walls)
+        , expansions(0)
+    {}
+};
+
+const std::size_t path_builder::unlabeled_expansion_limit;
+const std::size_t path_builder::enclosure_probe;
+const int path_builder::enclosure_radius;
+
+path_builder::path_builder() :
+      world_size({ 25, 25 })
+    , open_list_mode(open_list_type::BINARY_HEAP)
+    , backend(search_backend::NODE_GRAPH)
+    , mode(search_mode::ASTAR)
+    , jump_points(walls)
+    , hierarchy(walls)
+    , bidirectional(walls)
+    , replanner(walls)
+    , anytime(walls)
+    , flow(walls)
+    , contraction(walls)
+    , any_angle(walls)
+    , bounded(walls)
+    , memory_bounded(walls)
+    , fringe(walls)
+    , components(walls)
+    , reachability_check(true)
+    , hierarchical_guarantee(false)
+    , map_version(0)
+    , heuristic_version(0)
+    , time_budget(0.0)
+    , expansion_limit(0)
+    , heuristic_kind(heuristic_type::CUSTOM)
+    , expansions(0)
+    , hierarchical_cost(-1)
+    , hierarchical_bound(1.0)
 {
     // Manhattan (4 directions) by default
     set_diagonal_movement(false);
     set_heuristic(manhattan);
     
+    // Straight moves first, then diagonals
     direction = 
     {
-        { 0, 1 }, { 1, 0 }, { 1, 0 }, { 0, -1},
-        { -1, -1 }, { 1, 1 }, { 0, 1 }, { 1, 1 }
+        { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
+        { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }
     };
+    
+    walls.resize(world_size);
 
     actor_ptr = new actor();
     if (actor_ptr != nullptr) init_collisions();
@@ -65,31 +120,107 @@ void path_builder::clear()
         actor_ptr = nullptr;
     }
     
-    for (auto it = open_list.begin(); it != open_list.end();)
-    {
-        delete *it;
-        it = open_list.erase(it);
-    }
-        
-    for (auto it = closed_list.begin(); it != closed_list.end();)
-    {
-        delete *it;
-        it = closed_list.erase(it);
-    }
+    release_nodes();
+    
+    // Leaves the cells of the file alone
+    close_world();
     
     walls.clear();
     direction.clear();
 }
 
+// Frees the nodes of the last search in one step but keeps the world intact
+void path_builder::release_nodes()
+{
+    open_list.clear();
+    closed_list.clear();
+    
+    nodes.for_each([this](node* _node)
+    {
+        const std::size_t id = cell_index(_node->position);
+        
+        if (id < cell_nodes.size())
+            cell_nodes[id] = nullptr;
+    });
+    
+    nodes.release();
+}
+
 void path_builder::init_path_coordinates(int _start_x, int _start_y, int _end_x, int _end_y)
 {
     path_data_ref.start_coordinate = vector2_i({_start_x, _start_y});
     path_data_ref.end_coordinate = vector2_i({_end_x, _end_y});
 }
 
+// Collisions that still fit inside the new size are kept, a new size 
+// closes the world of open_world
 void path_builder::set_world_size(vector2_i _world_size)
 {
     world_size = _world_size;
+    walls.resize(world_size);
+    
+    if (!walls.is_tiled())
+        world_tiles.close();
+    
+    invalidate_world();
+}
+
+bool path_builder::open_world(const std::string& _path, std::size_t _tile_budget)
+{
+    release_nodes();
+    
+    // Opening closes the tiles of the last world even when it fails
+    if (!world_tiles.open(_path, _tile_budget))
+    {
+        close_world();
+        return false;
+    }
+    
+    walls.attach(world_tiles);
+    world_size = walls.get_size();
+    invalidate_world();
+    
+    return true;
+}
+
+void path_builder::close_world()
+{
+    if (!walls.is_tiled())
+        return;
+    
+    release_nodes();
+    walls.detach();
+    world_tiles.close();
+    world_size = walls.get_size();
+    invalidate_world();
+}
+
+bool path_builder::load_map(const std::string& _path)
+{
+    close_world();
+    release_nodes();
+    
+    const bool loaded = read_map_file(_path, walls);
+    
+    world_size = walls.get_size();
+    invalidate_world();
+    
+    // The random obstacles of init_collisions are gone
+    if (actor_ptr)
+        actor_ptr->obstacles.clear();
+    
+    return loaded;
+}
+
+void path_builder::invalidate_world()
+{
+    hierarchy.invalidate_all();
+    replanner.invalidate_all();
+    anytime.invalidate_all();
+    flow.invalidate();
+    contraction.invalidate();
+    components.invalidate_all();
+    ++map_version;
 }
 
 void path_builder::set_diagonal_movement(bool _enabled)
@@ -97,10 +228,130 @@ void path_builder::set_diagonal_movement(bool _enabled)
     directions = (_enabled ? 8 : 4);
 }
 
+landmark_heuristic path_builder::build_landmark_heuristic(std::size_t _count, thread_pool& _pool, std::size_t _threads) const
+{
+    // Falls back to the octagonal distance on worlds too large for tables
+    if (!has_cell_arrays())
+        return landmark_heuristic();
+    
+    return landmark_heuristic::build(walls, _count, directions == 8, _pool, _threads);
+}
+
+void path_builder::set_open_list(open_list_type _type)
+{
+    open_list_mode = _type;
+}
+
+void path_builder::set_search_mode(search_mode _mode)
+{
+    mode = _mode;
+}
+
+void path_builder::set_cluster_size(int _cluster_size)
+{
+    hierarchy.set_cluster_size(_cluster_size);
+    
+    // Cached hierarchical paths come from the old clusters
+    cache.clear();
+}
+
+void path_builder::set_time_budget(double _milliseconds)
+{
+    time_budget = std::max(0.0, _milliseconds);
+}
+
+void path_builder::set_anytime_weights(double _initial, double _step)
+{
+    anytime.set_weights(_initial, _step);
+}
+
+void path_builder::set_suboptimality(double _epsilon)
+{
+    bounded.set_epsilon(_epsilon);
+    
+    // Cached hierarchical paths were held to the old bound
+    cache.clear();
+}
+
+void path_builder::set_hierarchical_guarantee(bool _enabled)
+{
+    hierarchical_guarantee = _enabled;
+    cache.clear();
+}
+
+void path_builder::set_node_limit(std::size_t _nodes)
+{
+    memory_bounded.set_node_limit(_nodes);
+}
+
+void path_builder::set_expansion_limit(std::size_t _expansions)
+{
+    expansion_limit = _expansions;
+}
+
+double path_builder::get_suboptimality_bound() const
+{
+    const search_mode active = get_active_mode();
+    
+    if (active == search_mode::ANYTIME)
+        return anytime.get_bound();
+    
+    if (active == search_mode::WEIGHTED || active == search_mode::FOCAL)
+        return bounded.get_bound();
+    
+    if (active == search_mode::HIERARCHICAL)
+        return hierarchical_bound;
+    
+    return 1.0;
+}
+
+int32_t path_builder::get_path_cost() const
+{
+    const search_mode active = get_active_mode();
+    
+    if (active == search_mode::ANYTIME)
+        return anytime.get_cost();
+    
+    if (active == search_mode::WEIGHTED || active == search_mode::FOCAL)
+        return bounded.get_cost();
+    
+    if (active == search_mode::HIERARCHICAL)
+        return hierarchical_cost;
+    
+    return -1;
+}
+
+vector2_i path_builder::get_next_step(vector2_i _position, vector2_i _goal)
+{
+    if (!has_cell_arrays())
+        return _position;
+    
+    flow.update(_goal, directions == 8);
+    
+    return flow.get_next_step(_position);
+}
+
+vector2_array_i path_builder::pull_string(const vector2_array_i& _path) const
+{
+    return ::pull_string(walls, _path, directions == 8);
+}
+
+void path_builder::build_contraction_hierarchy()
+{
+    if (has_cell_arrays())
+        contraction.build(directions == 8);
+}
+
+void path_builder::set_search_backend(search_backend _backend)
+{
+    backend = _backend;
+}
+
 int path_builder::init()
 {
     open_list.clear();
     closed_list.clear();
+    expansions = 0;
     
     return SUCCESS;
 }
@@ -116,20 +367,57 @@ bool path_builder::is_data_valid()
 
 void path_builder::set_heuristic(std::function<int(vector2_i, vector2_i)> _heuristic)
 {
-    heuristic = std::bind(_heuristic, std::placeholders::_1, std::placeholders::_2);
+    // The built-in heuristics get a search kernel with the heuristic inlined
+    typedef int (*heuristic_function)(vector2_i, vector2_i);
+    const heuristic_function* target = _heuristic.target<heuristic_function>();
+    
+    heuristic_kind = heuristic_type::CUSTOM;
+    
+    if (target && *target == &path_builder::manhattan)
+        heuristic_kind = heuristic_type::MANHATTAN;
+    else if (target && *target == &path_builder::octagonal)
+        heuristic_kind = heuristic_type::OCTAGONAL;
+    else if (target && *target == &path_builder::euclidean)
+        heuristic_kind = heuristic_type::EUCLIDEAN;
+    else if (_heuristic.target<landmark_heuristic>())
+        heuristic_kind = heuristic_type::LANDMARK;
+    
+    heuristic = _heuristic;
+    ++heuristic_version;
+    replanner.invalidate_all();
+    anytime.invalidate_all();
 }
 
+// Cells outside the world are ignored, they always collide.  Writes that 
+// change no cell invalidate nothing.
 void path_builder::add_collision(vector2_i _coordinates)
 {
-    walls.push_back(_coordinates);
+    if (walls.set(_coordinates))
+    {
+        hierarchy.invalidate(_coordinates);
+        replanner.invalidate(_coordinates);
+        anytime.invalidate_all();
+        flow.invalidate();
+        contraction.invalidate();
+        components.block(_coordinates);
+        
+        // Paths elsewhere stay valid and cannot get shorter
+        cache.invalidate(_coordinates);
+    }
 }
 
 void path_builder::remove_collision(vector2_i _coordinates)
 {
-    auto it = std::find(walls.begin(), walls.end(), _coordinates);
-    
-    if (it != walls.end())
-        walls.erase(it);
+    if (walls.reset(_coordinates))
+    {
+        hierarchy.invalidate(_coordinates);
+        replanner.invalidate(_coordinates);
+        anytime.invalidate_all();
+        flow.invalidate();
+        contraction.invalidate();
+        components.unblock(_coordinates);
+        ++map_version;
+    }
 }
 
 // Set for (25, 25) grid with goal of (20, 20)
@@ -161,11 +449,344 @@ void path_builder::init_collisions()
 }
 
 vector2_array_i path_builder::find_path(const path_data& _data)
+{
+    // Labels take a word per cell, too many for a world without cell arrays, 
+    // where the memory-bounded search checks for enclosures instead
+    if (reachability_check && has_cell_arrays())
+    {
+        components.update(directions == 8);
+        
+        if (!components.is_connected(_data.start_coordinate, _data.end_coordinate))
+        {
+            expansions = 0;
+            hierarchical_cost = -1;
+            hierarchical_bound = std::numeric_limits<double>::infinity();
+            return {};
+        }
+    }
+    
+    const search_mode active = get_active_mode();
+    
+    if (cache.get_capacity() == 0 
+        || active == search_mode::ANYTIME 
+        || active == search_mode::ANY_ANGLE 
+        || active == search_mode::LAZY_ANY_ANGLE
+        || active == search_mode::WEIGHTED
+        || active == search_mode::FOCAL)
+        return search(_data);
+    
+    const path_cache::key query = 
+    {
+        _data.start_coordinate, _data.end_coordinate, 
+        static_cast<uint32_t>(active), static_cast<uint32_t>(directions), 
+        heuristic_version, map_version
+    };
+    
+    if (const path_cache::value* cached = cache.find(query))
+    {
+        expansions = 0;
+        hierarchical_cost = cached->cost;
+        hierarchical_bound = cached->bound;
+        return cached->path;
+    }
+    
+    vector2_array_i path = search(_data);
+    
+    // A partial path toward an unreachable goal depends on the whole 
+    // explored region, not only on its own cells
+    if (path.empty() || path.front() == static_cast<vector2_i>(_data.end_coordinate))
+        cache.insert(query, { path, get_path_cost(), get_suboptimality_bound() });
+    
+    return path;
+}
+
+void path_builder::set_reachability_check(bool _enabled)
+{
+    reachability_check = _enabled;
+}
+
+void path_builder::set_path_cache(std::size_t _capacity)
+{
+    cache.set_capacity(_capacity);
+}
+
+vector2_array_i path_builder::search(const path_data& _data)
+{
+    const search_mode active = get_active_mode();
+    
+    if (active == search_mode::JUMP_POINT)
+    {
+        auto path = jump_points.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic);
+        expansions = jump_points.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::HIERARCHICAL)
+    {
+        auto path = hierarchy.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic);
+        expansions = hierarchy.get_expansions();
+        hierarchical_cost = hierarchy.get_cost();
+        hierarchical_bound = hierarchy.get_bound();
+        
+        if (!hierarchical_guarantee || path.empty() || hierarchical_bound <= 1.0 + bounded.get_epsilon())
+            return path;
+        
+        // Weighted A* guarantees the bound HPA* could not prove
+        auto weighted = bounded.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic, false);
+        expansions += bounded.get_expansions();
+        
+        if (weighted.empty())
+            return path;
+        
+        // Both bounds are a cost over a lower bound on the optimal cost
+        const double lower = std::max(
+              hierarchical_cost / hierarchical_bound
+            , bounded.get_cost() / bounded.get_bound());
+        
+        if (bounded.get_cost() < hierarchical_cost)
+        {
+            path.swap(weighted);
+            hierarchical_cost = bounded.get_cost();
+        }
+        
+        hierarchical_bound = std::max(1.0, hierarchical_cost / lower);
+        return path;
+    }
+    
+    if (active == search_mode::BIDIRECTIONAL)
+    {
+        auto path = bidirectional.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic);
+        expansions = bidirectional.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::INCREMENTAL)
+    {
+        auto path = replanner.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic);
+        expansions = replanner.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::ANYTIME)
+    {
+        auto deadline = anytime_search::clock::time_point::max();
+        
+        if (time_budget > 0.0)
+            deadline = anytime_search::clock::now() 
+                + std::chrono::duration_cast<anytime_search::clock::duration>(
+                    std::chrono::duration<double, std::milli>(time_budget));
+        
+        auto path = anytime.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic, deadline);
+        expansions = anytime.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::FLOW_FIELD)
+    {
+        auto path = flow.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8);
+        expansions = flow.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::CONTRACTION)
+    {
+        auto path = contraction.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8);
+        expansions = contraction.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::ANY_ANGLE || active == search_mode::LAZY_ANY_ANGLE)
+    {
+        auto path = any_angle.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, 
+            active == search_mode::LAZY_ANY_ANGLE);
+        expansions = any_angle.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::WEIGHTED || active == search_mode::FOCAL)
+    {
+        auto path = bounded.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic, 
+            active == search_mode::FOCAL);
+        expansions = bounded.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::MEMORY_BOUNDED)
+    {
+        // Without labels, an unreachable goal would search the whole world
+        const std::size_t limit = (expansion_limit == 0 && !has_cell_arrays() ? unlabeled_expansion_limit : expansion_limit);
+        
+        // and one walled in would search until the limit, so searches that 
+        // outgrow enclosure_probe check that neither end is
+        memory_bounded.set_expansion_limit(limit);
+        memory_bounded.set_unreachable_check(
+              reachability_check && !has_cell_arrays() ? enclosure_probe : 0
+            , [this, &_data]() { return is_enclosed(_data.start_coordinate, _data.end_coordinate); });
+        
+        auto path = memory_bounded.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, heuristic);
+        expansions = memory_bounded.get_expansions();
+        return path;
+    }
+    
+    if (active == search_mode::FRINGE)
+    {
+        if (heuristic_kind == heuristic_type::EUCLIDEAN)
+            euclidean_table.resize(world_size);
+        
+        vector2_array_i path;
+        fringe.find_path(_data.start_coordinate, _data.end_coordinate, directions == 8, 
+            heuristic_kind, heuristic, euclidean_table, path);
+        expansions = fringe.get_expansions();
+        return path;
+    }
+    
+    if (backend == search_backend::CELL_ARRAYS)
+    {
+        if (open_list_mode == open_list_type::QUATERNARY_HEAP)
+            return find_path_cells(_data, quaternary_heap);
+        
+        if (open_list_mode == open_list_type::BUCKET_QUEUE)
+            return find_path_cells(_data, buckets);
+        
+        return find_path_cells(_data, binary_heap);
+    }
+    
+    switch (open_list_mode)
+    {
+        case open_list_type::LINEAR_SCAN:
+            return find_path_linear(_data);
+        case open_list_type::QUATERNARY_HEAP:
+            return find_path_heap(_data, quaternary_heap);
+        default:
+            return find_path_heap(_data, binary_heap);
+    }
+}
+
+void path_builder::find_paths(
+      const path_data* _queries
+    , std::size_t _count
+    , vector2_array_i* _results
+    , thread_pool& _pool
+    , std::size_t _threads)
+{
+    expansions = 0;
+    
+    // These modes keep one search state between queries, so they run here 
+    // in order, and so do all modes on tiles, which move in and out of memory
+    if (!has_cell_arrays()
+        || mode == search_mode::HIERARCHICAL 
+        || mode == search_mode::INCREMENTAL 
+        || mode == search_mode::ANYTIME
+        || mode == search_mode::FLOW_FIELD
+        || mode == search_mode::CONTRACTION
+        || mode == search_mode::ANY_ANGLE
+        || mode == search_mode::LAZY_ANY_ANGLE
+        || mode == search_mode::WEIGHTED
+        || mode == search_mode::FOCAL
+        || mode == search_mode::MEMORY_BOUNDED)
+    {
+        std::size_t total = 0;
+        
+        for (std::size_t i = 0; i < _count; ++i)
+        {
+            _results[i] = find_path(_queries[i]);
+            total += expansions;
+        }
+        
+        expansions = total;
+        return;
+    }
+    
+    _threads = std::max<std::size_t>(1, std::min(_threads, (_count + 15) / 16));
+    
+    // Built before the tasks start, which only read them
+    if (heuristic_kind == heuristic_type::EUCLIDEAN)
+        euclidean_table.resize(world_size);
+    
+    if (reachability_check)
+        components.update(directions == 8);
+    
+    while (batch_workers.size() < _threads)
+        batch_workers.emplace_back(new batch_worker(walls));
+    
+    // Tasks take 16 queries at a time so that uneven queries balance out
+    std::atomic<std::size_t> next(0);
+    const bool diagonal = (directions == 8);
+    
+    auto work = [&](batch_worker* _worker)
+    {
+        _worker->expansions = 0;
+        
+        for (;;)
+        {
+            const std::size_t first = next.fetch_add(16);
+            
+            if (first >= _count)
+                break;
+            
+            const std::size_t last = std::min(first + 16, _count);
+            
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const vector2_i start = _queries[i].start_coordinate;
+                const vector2_i goal = _queries[i].end_coordinate;
+                
+                if (reachability_check && !components.is_connected(start, goal))
+                {
+                    _results[i].clear();
+                    continue;
+                }
+                
+                if (mode == search_mode::JUMP_POINT)
+                {
+                    _results[i] = _worker->jump_points.find_path(start, goal, diagonal, heuristic);
+                    _worker->expansions += _worker->jump_points.get_expansions();
+                }
+                else if (mode == search_mode::BIDIRECTIONAL)
+                {
+                    _results[i] = _worker->bidirectional.find_path(start, goal, diagonal, heuristic);
+                    _worker->expansions += _worker->bidirectional.get_expansions();
+                }
+                else if (mode == search_mode::FRINGE)
+                {
+                    _worker->fringe.find_path(start, goal, diagonal, heuristic_kind, heuristic, euclidean_table, _results[i]);
+                    _worker->expansions += _worker->fringe.get_expansions();
+                }
+                else
+                {
+                    _worker->astar.find_path(start, goal, diagonal, heuristic_kind, heuristic, euclidean_table, _results[i]);
+                    _worker->expansions += _worker->astar.get_expansions();
+                }
+            }
+        }
+    };
+    
+    std::vector<std::future<void>> tasks;
+    
+    // A stopped pool leaves the remaining queries to the calling thread
+    try
+    {
+        for (std::size_t t = 1; t < _threads; ++t)
+            tasks.push_back(_pool.enqueue(work, batch_workers[t].get()));
+    }
+    catch (const std::runtime_error&) {}
+    
+    work(batch_workers[0].get());
+    
+    for (auto& task : tasks)
+        task.get();
+    
+    for (std::size_t t = 0; t <= tasks.size(); ++t)
+        expansions += batch_workers[t]->expansions;
+}
+
+// Original search: scans the whole open list for the cheapest node
+vector2_array_i path_builder::find_path_linear(const path_data& _data)
 {
     init();
   
     node* current = nullptr;
-    open_list.insert(new node(_data.start_coordinate));
+    open_list.insert(nodes.create(_data.start_coordinate));
         
     while (!open_list.empty()) 
     {
@@ -180,6 +801,7 @@ vector2_array_i path_builder::find_path(const path_data& _data)
             if (current->position == static_cast<vector2_i>(_data.end_coordinate))
                 break;
 
+            ++expansions;
             closed_list.insert(current);
             open_list.erase(std::find(open_list.begin(), open_list.end(), current));
 
@@ -205,7 +827,7 @@ vector2_array_i path_builder::find_path(const path_data& _data)
                 }
                 else
                 {
-                    successor = new node(new_coordinates, current);
+                    successor = nodes.create(new_coordinates, current);
                     successor->g = total_cost;
                     successor->h = heuristic(successor->position, _data.end_coordinate);
                     open_list.insert(successor);
@@ -227,7 +849,108 @@ vector2_array_i path_builder::find_path(const path_data& _data)
         current = current->parent;
     }
     
-    clear();
+    release_nodes();
+    return path;
+}
+
+// Pops the cheapest node from an indexed heap and finds neighbors through 
+// the cell table, so every step is O(log n) instead of O(n)
+template<class heap_type>
+vector2_array_i path_builder::find_path_heap(const path_data& _data, heap_type& _open)
+{
+    init();
+    
+    // The start has to be a cell of the world to be indexed
+    if (!walls.is_inside(_data.start_coordinate))
+        return {};
+    
+    const std::size_t cells = static_cast<std::size_t>(world_size.x) * world_size.y;
+    
+    _open.reset(cells);
+    
+    if (cell_nodes.size() != cells)
+        cell_nodes.assign(cells, nullptr);
+    
+    node* current = nodes.create(_data.start_coordinate);
+    const uint32_t start = static_cast<uint32_t>(cell_index(current->position));
+    cell_nodes[start] = current;
+    
+    _open.push(start, current->get_sum(), current->g);
+    current->set_state(node_state::IN_OPEN_LIST);
+    
+    while (!_open.empty())
+    {
+        current = cell_nodes[_open.pop()];
+        
+        if (current->position == static_cast<vector2_i>(_data.end_coordinate))
+            break;
+        
+        ++expansions;
+        current->set_state(node_state::IN_CLOSED_LIST);
+        
+        // From all movable directions, check the neighbors
+        for (int i = 0; i < directions; ++i) 
+        {
+            vector2_i new_coordinates(current->position + direction[i]);
+            
+            if (detect_collision(new_coordinates))
+                continue;
+            
+            const uint32_t id = static_cast<uint32_t>(cell_index(new_coordinates));
+            node* successor = cell_nodes[id];
+            
+            if (successor != nullptr && successor->get_state() == node_state::IN_CLOSED_LIST)
+                continue;
+            
+            double total_cost = current->g + (i < 4 ? 10 : 14); // if i < 4 directions...
+            
+            if (successor != nullptr)
+            {
+                if (total_cost < successor->g) 
+                {
+                    successor->parent = current;
+                    successor->g = total_cost;
+                    _open.decrease(id, successor->get_sum(), successor->g);
+                }
+            }
+            else
+            {
+                successor = nodes.create(new_coordinates, current, node_state::IN_OPEN_LIST);
+                successor->g = total_cost;
+                successor->h = heuristic(successor->position, _data.end_coordinate);
+                cell_nodes[id] = successor;
+                _open.push(id, successor->get_sum(), successor->g);
+            }
+        }
+    }
+    
+    vector2_array_i path;
+    
+    while (current != nullptr)
+    {
+        path.push_back(current->position);
+        current = current->parent;
+    }
+    
+    _open.clear();
+    release_nodes();
+    return path;
+}
+
+// Same search as find_path_heap, but the cells live in flat arrays instead 
+// of nodes and the parent is stored as an index into the direction table
+template<class heap_type>
+vector2_array_i path_builder::find_path_cells(const path_data& _data, heap_type& _open)
+{
+    init();
+    
+    if (heuristic_kind == heuristic_type::EUCLIDEAN)
+        euclidean_table.resize(world_size);
+    
+    vector2_array_i path;
+    expansions = search_cells(walls, cells, _open, _data.start_coordinate, _data.end_coordinate, 
+        directions == 8, heuristic_kind, heuristic, euclidean_table, path);
+    
     return path;
 }
 
@@ -241,16 +964,87 @@ node* path_builder::get_node(std::set<node*>& _nodes, vector2_i _coordinates)
     return nullptr;
 }
 
-// Checks if the point lies inside the obstacle
+// Checks if the point lies inside the obstacle or outside the world
 bool path_builder::detect_collision(vector2_i _coordinates)
 {
-    if (  _coordinates.x < 0 || _coordinates.x >= world_size.x 
-       || _coordinates.y < 0 || _coordinates.y >= world_size.y 
-       || std::find(walls.begin(), walls.end(), _coordinates) != walls.end()) 
+    return walls.is_blocked(_coordinates);
+}
+
+bool path_builder::is_enclosed(vector2_i _start, vector2_i _goal) const
+{
+    // The searches return no path for blocked ends themselves
+    if (walls.is_blocked(_start) || walls.is_blocked(_goal))
+        return false;
+    
+    // Each end is filled within a window of 2 * enclosure_radius + 1 cells 
+    // around it, marked in a bitmap, and is open once the fill reaches its edge
+    const int side_cells = 2 * enclosure_radius + 1;
+    const std::size_t center = static_cast<std::size_t>(enclosure_radius) * side_cells + enclosure_radius;
+    const vector2_i ends[2] = { _start, _goal };
+    std::vector<uint64_t> seen[2];
+    std::vector<vector2_i> queue[2];
+    std::size_t next[2] = { 0, 0 };
+    bool open[2] = { false, false };
+    
+    for (int side = 0; side < 2; ++side)
     {
-        return true;
+        seen[side].assign((static_cast<std::size_t>(side_cells) * side_cells + 63) / 64, 0);
+        queue[side].push_back(ends[side]);
+        seen[side][center >> 6] |= uint64_t(1) << (center & 63);
     }
-  
+    
+    // One cell from each end in turns, so that the smaller enclosure is 
+    // found after about twice its cells
+    for (int side = 0; !open[0] || !open[1]; side ^= 1)
+    {
+        if (open[side])
+            continue;
+        
+        // Every cell this end reaches is filled, and the other is not one
+        if (next[side] == queue[side].size())
+            return true;
+        
+        const vector2_i cell = queue[side][next[side]++];
+        
+        for (int i = 0; i < directions; ++i)
+        {
+            const int nx = cell.x + grid_direction_x[i];
+            const int ny = cell.y + grid_direction_y[i];
+            
+            if (walls.is_blocked(nx, ny))
+                continue;
+            
+            // The fills met
+            const int ox = nx - ends[side ^ 1].x + enclosure_radius;
+            const int oy = ny - ends[side ^ 1].y + enclosure_radius;
+            
+            if (ox >= 0 && oy >= 0 && ox < side_cells && oy < side_cells)
+            {
+                const std::size_t bit = static_cast<std::size_t>(oy) * side_cells + ox;
+                
+                if ((seen[side ^ 1][bit >> 6] >> (bit & 63)) & 1)
+                    return false;
+            }
+            
+            const int x = nx - ends[side].x + enclosure_radius;
+            const int y = ny - ends[side].y + enclosure_radius;
+            
+            if (x < 0 || y < 0 || x >= side_cells || y >= side_cells)
+            {
+                open[side] = true;
+                break;
+            }
+            
+            const std::size_t bit = static_cast<std::size_t>(y) * side_cells + x;
+            
+            if ((seen[side][bit >> 6] >> (bit & 63)) & 1)
+                continue;
+            
+            seen[side][bit >> 6] |= uint64_t(1) << (bit & 63);
+            queue[side].push_back({ nx, ny });
+        }
+    }
+    
     return false;
 }
 
@@ -261,18 +1055,15 @@ vector2_i path_builder::distance(vector2_i _current, vector2_i _neighbor)
 
 int path_builder::euclidean(vector2_i _current, vector2_i _neighbor) // any direction
 {
-    auto delta = std::move(distance(_current, _neighbor));
-    return static_cast<int>(10 * sqrt(pow(delta.x, 2) + pow(delta.y, 2)));
+    return euclidean_policy()(_current, _neighbor);
 }
 
 int path_builder::manhattan(vector2_i _current, vector2_i _neighbor) 
 {
-    auto delta = std::move(distance(_current, _neighbor));
-    return static_cast<int>(10 * (delta.x + delta.y));
+    return manhattan_policy()(_current, _neighbor);
 }
 
 int path_builder::octagonal(vector2_i _current, vector2_i _neighbor) 
 {
-    auto delta = std::move(distance(_current, _neighbor));
-    return (10 * (delta.x + delta.y) + (-6) * std::min(delta.x, delta.y));
+    return octagonal_policy()(_current, _neighbor);
 }
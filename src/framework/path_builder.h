@@ -28,7 +28,33 @@
 #include <cstdint>
 #include <functional>
 #include <set>
+#include <string>
+#include <vector>
 #include <framework/node.h>
+#include <framework/node_pool.h>
+#include <framework/any_angle_search.h>
+#include <framework/anytime_search.h>
+#include <framework/astar_search.h>
+#include <framework/bidirectional_search.h>
+#include <framework/bounded_search.h>
+#include <framework/bucket_queue.h>
+#include <framework/connected_components.h>
+#include <framework/contraction_hierarchy.h>
+#include <framework/dstar_lite.h>
+#include <framework/flow_field.h>
+#include <framework/fringe_search.h>
+#include <framework/hierarchical_planner.h>
+#include <framework/indexed_heap.h>
+#include <framework/jump_point_search.h>
+#include <framework/landmark_heuristic.h>
+#include <framework/line_of_sight.h>
+#include <framework/memory_bounded_search.h>
+#include <framework/moving_ai_loader.h>
+#include <framework/occupancy_grid.h>
+#include <framework/path_cache.h>
+#include <framework/search_grid.h>
+#include <framework/search_kernel.h>
+#include <framework/tiled_grid.h>
 #include <math/linear_algebra/vector.h>
 #include <core/path_interface.h>
 #include <core/object.h>
@@ -59,6 +85,41 @@ struct path_data
     }
 };
 
+// Containers that can hold the open list during a search
+enum open_list_type
+{
+    LINEAR_SCAN,        // std::set scanned for the cheapest node every step
+    BINARY_HEAP,        // indexed 2-ary heap with decrease-key
+    QUATERNARY_HEAP,    // indexed 4-ary heap with decrease-key
+    BUCKET_QUEUE        // one bucket per integer f, cell arrays only
+};
+
+// Where the search keeps the state of the cells it visits
+enum search_backend
+{
+    NODE_GRAPH,     // heap-allocated nodes linked by parent pointers
+    CELL_ARRAYS     // flat per-cell arrays reset by generation stamp
+};
+
+// Algorithms find_path can run
+enum search_mode
+{
+    ASTAR,          // expands every cell
+    JUMP_POINT,     // expands jump points only, needs the uniform 10/14 costs
+    HIERARCHICAL,   // searches cached cluster entrances, then refines (HPA*), see set_hierarchical_guarantee
+    BIDIRECTIONAL,  // A* from both ends until the frontiers meet
+    INCREMENTAL,    // D* Lite, repairs the last search after collision changes
+    ANYTIME,        // ARA*, improves a weighted A* path until the time budget runs out
+    FLOW_FIELD,     // Dijkstra from the goal shared by every query to that goal
+    CONTRACTION,    // upward search of a contraction hierarchy, A* until build_contraction_hierarchy
+    ANY_ANGLE,      // Theta*, returns the waypoints of a path of straight segments
+    LAZY_ANY_ANGLE, // Lazy Theta*, one line of sight check per expansion
+    WEIGHTED,       // weighted A*, at most (1 + epsilon) * optimal cost with a consistent heuristic
+    FOCAL,          // focal search, same bound with any admissible one, prefers cells closest to the goal
+    MEMORY_BOUNDED, // IDA* with a transposition table of at most the node limit
+    FRINGE          // Fringe Search, sweeps a list of open cells per f threshold instead of a heap
+};
+
 class path_builder : public object, public path_interface
 {
     
@@ -81,6 +142,147 @@ public:
     static int octagonal(vector2_i _current, vector2_i _neighbor);
     void set_diagonal_movement(bool _enabled);
     
+    // ALT heuristic for the current collisions and movement, to pass to 
+    // set_heuristic.  Builds _count landmarks on up to _threads tasks of _pool.
+    landmark_heuristic build_landmark_heuristic(std::size_t _count, class thread_pool& _pool, std::size_t _threads) const;
+    
+    // A* by default.  Jump Point Search follows set_diagonal_movement.
+    void set_search_mode(search_mode _mode);
+    inline search_mode get_search_mode() const { return mode; }
+    
+    // Mode find_path runs: the memory-bounded one on the worlds without cell 
+    // arrays, see open_world, and A* in place of a contraction hierarchy that 
+    // is not built
+    inline search_mode get_active_mode() const
+    {
+        if (!has_cell_arrays())
+            return search_mode::MEMORY_BOUNDED;
+        
+        if (mode == search_mode::CONTRACTION && !contraction.is_built(directions == 8))
+            return search_mode::ASTAR;
+        
+        return mode;
+    }
+    
+    // Width of the square clusters of the hierarchical mode, 16 by default
+    void set_cluster_size(int _cluster_size);
+    
+    // Milliseconds the anytime mode may spend per call, 0 (no limit) by default
+    void set_time_budget(double _milliseconds);
+    
+    // First weight of the anytime mode and how much each pass lowers it
+    void set_anytime_weights(double _initial, double _step);
+    
+    // Cost the weighted and focal modes may exceed the optimal one by, as a 
+    // fraction of it, 0.2 by default.  Their paths cost at most 
+    // (1 + epsilon) * C*, C* the optimal cost: weighted ones when the 
+    // heuristic is consistent, like manhattan with 4 directions or octagonal 
+    // with 8, and focal ones when it never overestimates.
+    void set_suboptimality(double _epsilon);
+    
+    // Holds hierarchical paths to the bound of weighted A*, off by default.  
+    // HPA* alone has no fixed bound and only reports cost / h(start, goal).  
+    // On, paths that this does not prove within 1 + epsilon are searched 
+    // again with weighted A* and the cheaper path is returned, which costs 
+    // about a weighted search for every query with a detour.
+    void set_hierarchical_guarantee(bool _enabled);
+    
+    // Upper bound on cost / optimal cost of the last anytime, weighted, focal
+    // or hierarchical path, from the path cache too, 1 in the other modes
+    double get_suboptimality_bound() const;
+    
+    // Cost of the last anytime, weighted, focal or hierarchical path in 10/14 
+    // units, -1 in the other modes or when there is no path
+    int32_t get_path_cost() const;
+    
+    // Cells the memory-bounded mode remembers, 65536 by default.  Fewer 
+    // cells cost re-expansions instead of memory.
+    void set_node_limit(std::size_t _nodes);
+    
+    // Expansions after which the memory-bounded mode returns no path.  0, 
+    // the default, means no limit where the reachability check applies and 
+    // 2^26 on the worlds it cannot label, see open_world, where an 
+    // unreachable goal would otherwise search every cell.
+    void set_expansion_limit(std::size_t _expansions);
+    
+    // Searches the collisions of the tile file at _path, written by 
+    // tiled_grid::create, instead of a world in memory, and keeps at most 
+    // _tile_budget tiles of it in memory.  Collisions added or removed go to 
+    // the file.  False when _path is no tile file.
+    // 
+    // Only the memory-bounded mode has no per-cell arrays the size of the 
+    // world, so every mode searches like it on tiled worlds, and on worlds 
+    // of more than 2^31 cells.  Those worlds skip the reachability check, 
+    // flow fields, landmarks and contraction hierarchies.
+    bool open_world(const std::string& _path, std::size_t _tile_budget);
+    
+    // Back to a world in memory, of no cells until set_world_size
+    void close_world();
+    
+    // Size, budget and loads of the tiles of open_world
+    inline const tiled_grid& get_world_tiles() const { return world_tiles; }
+    
+    // Replaces the world with the MovingAI .map file at _path, see 
+    // read_map_file.  False, with an empty world, when it is not a map.
+    bool load_map(const std::string& _path);
+    
+    // Size set by set_world_size, open_world or load_map
+    inline vector2_i get_world_size() const { return world_size; }
+    
+    // Next cell toward _goal in O(1) once the flow field of _goal is built,
+    // _position itself at the goal, when the goal cannot be reached or on 
+    // a world too large for a field
+    vector2_i get_next_step(vector2_i _position, vector2_i _goal);
+    
+    // Waypoints of _path that a straight line cannot skip, for paths of 
+    // any mode.  Segments stay clear of collisions like any-angle paths.
+    vector2_array_i pull_string(const vector2_array_i& _path) const;
+    
+    // Preprocesses the current collisions and movement for the contraction 
+    // mode, which searches like A* until then.  Builds take seconds to 
+    // minutes, 84 s on a 512 x 512 random world with diagonal movement, so 
+    // find_path never starts one.  Any collision change, resize or change 
+    // of movement drops the hierarchy until the next call.
+    void build_contraction_hierarchy();
+    inline const contraction_hierarchy& get_contraction_hierarchy() const { return contraction; }
+    
+    // Returns no path without searching when no path joins start and goal, 
+    // on by default.  Off, A* returns its partial path toward the goal.  
+    // Worlds without cell arrays have no labels, so there it only catches 
+    // start or goal walled in within 64 cells of it, once a search has taken 
+    // 2^16 expansions.
+    void set_reachability_check(bool _enabled);
+    
+    // Keeps the last _capacity paths of find_path, 0 (off) by default, with 
+    // the cost and bound of hierarchical paths.  Anytime paths depend on the 
+    // time budget, any-angle paths cross cells between their waypoints and 
+    // weighted and focal searches report their bound, so none of them are 
+    // cached.  find_paths only uses the cache in the modes it runs in order.
+    void set_path_cache(std::size_t _capacity);
+    
+    // Hit, miss and eviction counters of the path cache
+    inline const path_cache& get_path_cache() const { return cache; }
+    
+    // Binary heap by default
+    void set_open_list(open_list_type _type);
+    
+    // Node graph by default.  Cell arrays use the binary heap for the linear 
+    // scan, the node graph uses it for the bucket queue.
+    void set_search_backend(search_backend _backend);
+    
+    // Nodes expanded by the last call to find_path, or by all of find_paths
+    inline std::size_t get_expansions() const { return expansions; }
+    
+    // Solves _count queries on up to _threads tasks of _pool, the calling 
+    // thread included, and writes each path to the matching entry of 
+    // _results.  Collisions must not change until it returns.
+    void find_paths(
+          const path_data* _queries
+        , std::size_t _count
+        , vector2_array_i* _results
+        , class thread_pool& _pool
+        , std::size_t _threads);
+    
     struct path_data path_data_ref;
 
     //~ Begin Path Interface
@@ -97,16 +299,95 @@ public:
     
 private:
 
+    static const std::size_t unlabeled_expansion_limit = std::size_t(1) << 26;
+    static const std::size_t enclosure_probe = std::size_t(1) << 16;    // expansions of a search before is_enclosed
+    static const int enclosure_radius = 64;                             // cells is_enclosed fills around each end
+    
     vector2_i world_size;
     vector2_array_i direction;
-    vector2_array_i walls;
+    tiled_grid world_tiles;             // open while walls reads from it
+    occupancy_grid walls;
     int directions;
     std::function<int(vector2_i, vector2_i)> heuristic;
+    
+    open_list_type open_list_mode;
+    indexed_heap<double, 2> binary_heap;
+    indexed_heap<double, 4> quaternary_heap;
+    bucket_queue<int32_t> buckets;
+    node_pool nodes;                    // owns every node of the current query
+    std::vector<node*> cell_nodes;      // cell id -> node generated by this query
+    search_backend backend;
+    search_grid cells;
+    search_mode mode;
+    jump_point_search jump_points;
+    hierarchical_planner hierarchy;
+    bidirectional_search bidirectional;
+    dstar_lite replanner;
+    anytime_search anytime;
+    flow_field flow;
+    contraction_hierarchy contraction;
+    any_angle_search any_angle;
+    bounded_search bounded;
+    memory_bounded_search memory_bounded;
+    fringe_search fringe;
+    path_cache cache;
+    connected_components components;
+    bool reachability_check;
+    bool hierarchical_guarantee;
+    uint64_t map_version;               // bumped when a path may have become shorter
+    uint64_t heuristic_version;         // bumped by set_heuristic
+    double time_budget;
+    std::size_t expansion_limit;
+    heuristic_type heuristic_kind;      // lets the cell arrays use a specialized kernel
+    distance_table euclidean_table;     // euclidean heuristic of every offset, built on first use
+    std::size_t expansions;
+    int32_t hierarchical_cost;          // of the last hierarchical path, searched or cached
+    double hierarchical_bound;
+    
+    struct batch_worker;
+    std::vector<std::unique_ptr<batch_worker>> batch_workers;  // search state of each task of find_paths
                         
     bool detect_collision(vector2_i _coordinates);
     
+    // Whether _start or _goal is walled in within enclosure_radius cells 
+    // without the other, found by filling from both in turns
+    bool is_enclosed(vector2_i _start, vector2_i _goal) const;
+    
+    // Drops the state every planner built for the last world
+    void invalidate_world();
+    
     node* get_node(std::set<node*>& _nodes, vector2_i _coordinates);
     
+    inline std::size_t cell_index(vector2_i _coordinates) const
+    {
+        return static_cast<std::size_t>(_coordinates.y) * world_size.x + _coordinates.x;
+    }
+    
+    inline vector2_i cell_position(std::size_t _id) const
+    {
+        return { static_cast<int>(_id % world_size.x), static_cast<int>(_id / world_size.x) };
+    }
+    
+    // Whether per-cell arrays fit, which index cells with an int and are 
+    // never allocated for the tiles of open_world
+    inline bool has_cell_arrays() const
+    {
+        return (!walls.is_tiled() && static_cast<std::size_t>(world_size.x) * world_size.y <= INT32_MAX);
+    }
+    
+    // find_path without the cache
+    vector2_array_i search(const path_data& _data);
+    
+    vector2_array_i find_path_linear(const path_data& _data);
+    
+    template<class heap_type>
+    vector2_array_i find_path_heap(const path_data& _data, heap_type& _open);
+    
+    template<class heap_type>
+    vector2_array_i find_path_cells(const path_data& _data, heap_type& _open);
+    
+    void release_nodes();
+    
     class actor* actor_ptr;
 
 };
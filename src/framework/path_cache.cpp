@@ -0,0 +1,168 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "path_cache.h"
+#include <iterator>
+
+bool path_cache::key::operator==(const key& _other) const
+{
+    return start == static_cast<vector2_i>(_other.start)
+        && goal == static_cast<vector2_i>(_other.goal)
+        && mode == _other.mode
+        && directions == _other.directions
+        && heuristic == _other.heuristic
+        && version == _other.version;
+}
+
+std::size_t path_cache::key_hash::operator()(const key& _key) const
+{
+    // FNV-1a over the fields
+    uint64_t hash = 14695981039346656037ULL;
+    const uint64_t fields[] = 
+    {
+        cell_key(_key.start), cell_key(_key.goal), 
+        (static_cast<uint64_t>(_key.mode) << 32) | _key.directions, 
+        _key.heuristic, _key.version
+    };
+    
+    for (uint64_t field : fields)
+    {
+        hash ^= field;
+        hash *= 1099511628211ULL;
+    }
+    
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+path_cache::path_cache(std::size_t _capacity) :
+      capacity(_capacity)
+    , hits(0)
+    , misses(0)
+    , evictions(0)
+    , invalidations(0)
+{}
+
+void path_cache::set_capacity(std::size_t _capacity)
+{
+    capacity = _capacity;
+    
+    while (entries.size() > capacity)
+    {
+        erase(std::prev(entries.end()));
+        ++evictions;
+    }
+}
+
+const path_cache::value* path_cache::find(const key& _key)
+{
+    auto found = lookup.find(_key);
+    
+    if (found == lookup.end())
+    {
+        ++misses;
+        return nullptr;
+    }
+    
+    ++hits;
+    entries.splice(entries.begin(), entries, found->second);
+    
+    return &found->second->result;
+}
+
+void path_cache::insert(const key& _key, const value& _value)
+{
+    if (capacity == 0)
+        return;
+    
+    auto found = lookup.find(_key);
+    
+    if (found != lookup.end())
+        erase(found->second);
+    
+    while (entries.size() >= capacity)
+    {
+        erase(std::prev(entries.end()));
+        ++evictions;
+    }
+    
+    entries.push_front({ _key, _value });
+    lookup[_key] = entries.begin();
+    
+    for (const auto& cell : _value.path)
+        crossings[cell_key(cell)].push_back(entries.begin());
+}
+
+std::size_t path_cache::invalidate(vector2_i _coordinates)
+{
+    auto found = crossings.find(cell_key(_coordinates));
+    
+    if (found == crossings.end())
+        return 0;
+    
+    // erase() edits the list being walked, so take it first
+    std::vector<entry_iterator> blocked;
+    blocked.swap(found->second);
+    crossings.erase(found);
+    
+    for (auto item : blocked)
+        erase(item);
+    
+    invalidations += blocked.size();
+    
+    return blocked.size();
+}
+
+void path_cache::clear()
+{
+    entries.clear();
+    lookup.clear();
+    crossings.clear();
+}
+
+void path_cache::erase(entry_iterator _entry)
+{
+    // Drop the entry from the index of every cell it crosses
+    for (const auto& cell : _entry->result.path)
+    {
+        auto found = crossings.find(cell_key(cell));
+        
+        if (found == crossings.end())
+            continue;
+        
+        std::vector<entry_iterator>& paths = found->second;
+        
+        for (std::size_t i = 0; i < paths.size(); ++i)
+            if (paths[i] == _entry)
+            {
+                paths[i] = paths.back();
+                paths.pop_back();
+                break;
+            }
+        
+        if (paths.empty())
+            crossings.erase(found);
+    }
+    
+    lookup.erase(_entry->query);
+    entries.erase(_entry);
+}
@@ -0,0 +1,126 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Least recently used cache of find_path results.
+ * 
+ * Paths are keyed by their query and by the version of the collisions 
+ * they were found on, so bumping the version retires every path at once 
+ * and the old entries age out.  Adding a collision cannot shorten any 
+ * path, so it only evicts the cached paths that cross the blocked cell, 
+ * found through a reverse index from cells to paths.
+ */
+class path_cache
+{
+    
+public:
+    
+    struct key
+    {
+        vector2_i start;
+        vector2_i goal;
+        uint32_t mode;
+        uint32_t directions;
+        uint64_t heuristic;     // changes whenever the heuristic does
+        uint64_t version;       // changes whenever a path may get shorter
+        
+        bool operator==(const key& _other) const;
+    };
+    
+    // Path of a query with the cost and bound find_path reported for it
+    struct value
+    {
+        vector2_array_i path;
+        int32_t cost;
+        double bound;
+    };
+    
+    explicit path_cache(std::size_t _capacity = 0);
+    
+    // Evicts the least recently used paths beyond _capacity, 0 disables the cache
+    void set_capacity(std::size_t _capacity);
+    
+    // Cached result of the query or nullptr, valid until the next change to the cache
+    const value* find(const key& _key);
+    
+    void insert(const key& _key, const value& _value);
+    
+    // Evicts every cached path through the cell and returns how many
+    std::size_t invalidate(vector2_i _coordinates);
+    
+    void clear();
+    
+    inline std::size_t get_capacity() const { return capacity; }
+    inline std::size_t get_size() const { return entries.size(); }
+    inline std::size_t get_hits() const { return hits; }
+    inline std::size_t get_misses() const { return misses; }
+    
+    // Paths dropped to make room, and paths dropped because a cell was blocked
+    inline std::size_t get_evictions() const { return evictions; }
+    inline std::size_t get_invalidations() const { return invalidations; }
+    
+private:
+    
+    struct entry
+    {
+        key query;
+        value result;
+    };
+    
+    typedef std::list<entry>::iterator entry_iterator;
+    
+    struct key_hash
+    {
+        std::size_t operator()(const key& _key) const;
+    };
+    
+    std::size_t capacity;
+    std::list<entry> entries;       // most recently used first
+    std::unordered_map<key, entry_iterator, key_hash> lookup;
+    std::unordered_map<uint64_t, std::vector<entry_iterator>> crossings;   // cell -> paths through it
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+    std::size_t invalidations;
+    
+    inline static uint64_t cell_key(vector2_i _coordinates)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(_coordinates.x)) << 32) 
+            | static_cast<uint32_t>(_coordinates.y);
+    }
+    
+    void erase(entry_iterator _entry);
+    
+};
+
+#endif /* PATH_CACHE_H */
@@ -0,0 +1,116 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SEARCH_GRID_H
+#define SEARCH_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <framework/node.h>
+
+// Grid moves that parent directions index: straight moves first, then 
+// diagonals, in the order of the direction table of path_builder
+const int grid_direction_x[8] = { 0, 1, 0, -1, -1, 1, -1, 1 };
+const int grid_direction_y[8] = { 1, 0, -1, 0, -1, 1, 1, -1 };
+
+/*
+ * Search state of every cell kept in flat arrays indexed by cell id.
+ * 
+ * A cell stores its g cost, the direction it was reached from and its 
+ * open/closed state, 9 bytes in total.  Cells are only valid when their 
+ * stamp matches the current generation, so reset() between queries is O(1).
+ */
+class search_grid
+{
+    
+public:
+    
+    static const uint8_t no_parent = 0x8;
+    
+    explicit search_grid() : generation(1) {}
+    
+    // Keeps the arrays when the number of cells is unchanged
+    void resize(std::size_t _cells)
+    {
+        if (stamps.size() == _cells)
+            return;
+        
+        g.assign(_cells, 0);
+        info.assign(_cells, 0);
+        stamps.assign(_cells, 0);
+        generation = 1;
+    }
+    
+    // Forgets every cell by starting a new generation
+    inline void reset()
+    {
+        if (++generation == 0)
+        {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+    
+    inline node_state get_state(uint32_t _id) const
+    {
+        if (stamps[_id] != generation)
+            return node_state::NONE;
+        
+        return static_cast<node_state>(info[_id] & 0x3);
+    }
+    
+    inline int32_t get_g(uint32_t _id) const { return g[_id]; }
+    
+    // Index into the direction table, or no_parent for the start
+    inline uint8_t get_parent(uint32_t _id) const { return (info[_id] >> 2) & 0xF; }
+    
+    // Puts the cell in the open list with a new cost and parent direction
+    inline void open(uint32_t _id, int32_t _g, uint8_t _parent)
+    {
+        stamps[_id] = generation;
+        g[_id] = _g;
+        info[_id] = static_cast<uint8_t>(node_state::IN_OPEN_LIST | (_parent << 2));
+    }
+    
+    inline void close(uint32_t _id)
+    {
+        info[_id] = static_cast<uint8_t>((info[_id] & ~0x3) | node_state::IN_CLOSED_LIST);
+    }
+    
+    inline std::size_t get_memory_usage() const 
+    { 
+        return stamps.size() * (sizeof(int32_t) + sizeof(uint8_t) + sizeof(uint32_t)); 
+    }
+    
+private:
+    
+    std::vector<int32_t> g;
+    std::vector<uint8_t> info;      // state in bits 0-1, parent direction in bits 2-5
+    std::vector<uint32_t> stamps;
+    uint32_t generation;
+    
+};
+
+#endif /* SEARCH_GRID_H */
@@ -0,0 +1,382 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SEARCH_KERNEL_H
+#define SEARCH_KERNEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <framework/distance_table.h>
+#include <framework/landmark_heuristic.h>
+#include <framework/occupancy_grid.h>
+#include <framework/search_grid.h>
+#include <math/linear_algebra/vector.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Heuristics that search_cells can pick at runtime
+enum heuristic_type
+{
+    CUSTOM,         // any std::function, called through the function
+    MANHATTAN,
+    OCTAGONAL,
+    EUCLIDEAN,
+    LANDMARK        // landmark_heuristic, scored through score_neighbors
+};
+
+/*
+ * Heuristic policies of the search kernel.  Each one is a functor taking 
+ * the cell and the goal, so a user functor with the same call signature can 
+ * be passed to search_cells as well.
+ */
+struct manhattan_policy
+{
+    inline int operator()(vector2_i _current, vector2_i _goal) const
+    {
+        return 10 * (std::abs(_current.x - _goal.x) + std::abs(_current.y - _goal.y));
+    }
+};
+
+struct octagonal_policy
+{
+    inline int operator()(vector2_i _current, vector2_i _goal) const
+    {
+        const int dx = std::abs(_current.x - _goal.x);
+        const int dy = std::abs(_current.y - _goal.y);
+        return 10 * (dx + dy) - 6 * std::min(dx, dy);
+    }
+};
+
+struct euclidean_policy
+{
+    inline int operator()(vector2_i _current, vector2_i _goal) const
+    {
+        return distance_table::compute(_current.x - _goal.x, _current.y - _goal.y);
+    }
+};
+
+// Euclidean read from a table that covers the world instead of sqrt
+struct euclidean_table_policy
+{
+    const distance_table& table;
+    
+    inline int operator()(vector2_i _current, vector2_i _goal) const
+    {
+        return table.get(std::abs(_current.x - _goal.x), std::abs(_current.y - _goal.y));
+    }
+};
+
+struct function_policy
+{
+    const std::function<int(vector2_i, vector2_i)>& function;
+    
+    inline int operator()(vector2_i _current, vector2_i _goal) const
+    {
+        return function(_current, _goal);
+    }
+};
+
+// Neighborhood policies, the first 4 or all 8 moves of grid_direction_x/y
+struct four_neighbors { static const int count = 4; };
+struct eight_neighbors { static const int count = 8; };
+
+// Bit i set when the move grid_direction_x/y[i] from (_x, _y) is blocked, 
+// read from three rows of the bitmap instead of one lookup per neighbor
+inline uint32_t blocked_neighbors(const occupancy_grid& _walls, int _x, int _y)
+{
+    const uint32_t above = _walls.get_row_triple(_x, _y + 1);
+    const uint32_t row = _walls.get_row_triple(_x, _y);
+    const uint32_t below = _walls.get_row_triple(_x, _y - 1);
+    
+    return ((above >> 1) & 1)
+        | (((row >> 2) & 1) << 1)
+        | (((below >> 1) & 1) << 2)
+        | ((row & 1) << 3)
+        | ((below & 1) << 4)
+        | (((above >> 2) & 1) << 5)
+        | ((above & 1) << 6)
+        | (((below >> 2) & 1) << 7);
+}
+
+/*
+ * Heuristic of every neighbor of (_x, _y) at once, written to _h in the 
+ * order of grid_direction_x/y.  Policies without an overload below are 
+ * called once per neighbor.
+ */
+template<class neighborhood, class heuristic_policy>
+inline void score_neighbors(const heuristic_policy& _heuristic, int _x, int _y, vector2_i _goal, int32_t* _h)
+{
+    for (int i = 0; i < neighborhood::count; ++i)
+        _h[i] = _heuristic({ _x + grid_direction_x[i], _y + grid_direction_y[i] }, _goal);
+}
+
+// Landmark tables are read once per expansion for all neighbors
+template<class neighborhood>
+inline void score_neighbors(const landmark_heuristic& _heuristic, int _x, int _y, vector2_i _goal, int32_t* _h)
+{
+    _heuristic.score_neighbors(_x, _y, _goal, neighborhood::count, _h);
+}
+
+#if defined(__SSE2__)
+
+// Absolute offsets to the goal of 4 neighbors starting at _lane
+inline void neighbor_deltas(int _x, int _y, vector2_i _goal, int _lane, __m128i& _dx, __m128i& _dy)
+{
+    __m128i dx = _mm_add_epi32(_mm_set1_epi32(_x - _goal.x), 
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(grid_direction_x + _lane)));
+    __m128i dy = _mm_add_epi32(_mm_set1_epi32(_y - _goal.y), 
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(grid_direction_y + _lane)));
+    
+    // SSE2 has no abs or min for 32-bit lanes
+    __m128i sign_x = _mm_srai_epi32(dx, 31);
+    __m128i sign_y = _mm_srai_epi32(dy, 31);
+    _dx = _mm_sub_epi32(_mm_xor_si128(dx, sign_x), sign_x);
+    _dy = _mm_sub_epi32(_mm_xor_si128(dy, sign_y), sign_y);
+}
+
+template<class neighborhood>
+inline void score_neighbors(const manhattan_policy&, int _x, int _y, vector2_i _goal, int32_t* _h)
+{
+    for (int lane = 0; lane < neighborhood::count; lane += 4)
+    {
+        __m128i dx, dy;
+        neighbor_deltas(_x, _y, _goal, lane, dx, dy);
+        
+        // 10 * (dx + dy)
+        __m128i sum = _mm_add_epi32(dx, dy);
+        sum = _mm_add_epi32(_mm_slli_epi32(sum, 3), _mm_slli_epi32(sum, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_h + lane), sum);
+    }
+}
+
+template<class neighborhood>
+inline void score_neighbors(const octagonal_policy&, int _x, int _y, vector2_i _goal, int32_t* _h)
+{
+    for (int lane = 0; lane < neighborhood::count; lane += 4)
+    {
+        __m128i dx, dy;
+        neighbor_deltas(_x, _y, _goal, lane, dx, dy);
+        
+        // 10 * (dx + dy) - 6 * min(dx, dy)
+        __m128i less = _mm_cmplt_epi32(dx, dy);
+        __m128i low = _mm_or_si128(_mm_and_si128(less, dx), _mm_andnot_si128(less, dy));
+        __m128i sum = _mm_add_epi32(dx, dy);
+        sum = _mm_add_epi32(_mm_slli_epi32(sum, 3), _mm_slli_epi32(sum, 1));
+        low = _mm_add_epi32(_mm_slli_epi32(low, 2), _mm_slli_epi32(low, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(_h + lane), _mm_sub_epi32(sum, low));
+    }
+}
+
+template<class neighborhood>
+inline void score_neighbors(const euclidean_table_policy& _heuristic, int _x, int _y, vector2_i _goal, int32_t* _h)
+{
+    alignas(16) int32_t dx[8];
+    alignas(16) int32_t dy[8];
+    
+    for (int lane = 0; lane < neighborhood::count; lane += 4)
+    {
+        __m128i lane_dx, lane_dy;
+        neighbor_deltas(_x, _y, _goal, lane, lane_dx, lane_dy);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dx + lane), lane_dx);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dy + lane), lane_dy);
+    }
+    
+    // SSE2 cannot gather, so the table is read one lane at a time
+    for (int i = 0; i < neighborhood::count; ++i)
+        _h[i] = _heuristic.table.get(dx[i], dy[i]);
+}
+
+#endif
+
+/*
+ * A* over the cell arrays with the neighborhood and heuristic fixed at 
+ * compile time, so that both inline into the expansion loop.
+ * 
+ * Fills _path from _goal back to _start, keeping its capacity.  An 
+ * unreachable goal gives the path to the last expanded cell, like 
+ * path_builder::find_path.  Returns the number of expanded cells.
+ */
+template<class neighborhood, class heuristic_policy, class heap_type>
+std::size_t search_cells(
+      const occupancy_grid& _walls
+    , search_grid& _cells
+    , heap_type& _open
+    , vector2_i _start
+    , vector2_i _goal
+    , const heuristic_policy& _heuristic
+    , vector2_array_i& _path)
+{
+    _path.clear();
+    
+    if (!_walls.is_inside(_start))
+        return 0;
+    
+    const int width = _walls.get_size().x;
+    const std::size_t count = static_cast<std::size_t>(width) * _walls.get_size().y;
+    std::size_t expansions = 0;
+    
+    _open.reset(count);
+    _cells.resize(count);
+    _cells.reset();
+    
+    const uint32_t goal = (_walls.is_inside(_goal) 
+        ? static_cast<uint32_t>(_goal.y * width + _goal.x) : heap_type::npos);
+    
+    // Cell id offset of every move
+    int32_t offsets[8];
+    
+    for (int i = 0; i < 8; ++i)
+        offsets[i] = grid_direction_y[i] * width + grid_direction_x[i];
+    
+    uint32_t current = static_cast<uint32_t>(_start.y * width + _start.x);
+    _cells.open(current, 0, search_grid::no_parent);
+    _open.push(current, 0, 0);
+    
+    while (!_open.empty())
+    {
+        current = _open.pop();
+        
+        if (current == goal)
+            break;
+        
+        ++expansions;
+        _cells.close(current);
+        
+        const int x = static_cast<int>(current) % width;
+        const int y = static_cast<int>(current) / width;
+        const int32_t g = _cells.get_g(current);
+        const uint32_t blocked = blocked_neighbors(_walls, x, y);
+        
+        alignas(16) int32_t h[8];
+        score_neighbors<neighborhood>(_heuristic, x, y, _goal, h);
+        
+        for (int i = 0; i < neighborhood::count; ++i) 
+        {
+            if (blocked & (1u << i))
+                continue;
+            
+            const uint32_t id = static_cast<uint32_t>(static_cast<int32_t>(current) + offsets[i]);
+            const node_state state = _cells.get_state(id);
+            
+            if (state == node_state::IN_CLOSED_LIST)
+                continue;
+            
+            const int32_t total_cost = g + (i < 4 ? 10 : 14);
+            
+            if (state == node_state::IN_OPEN_LIST)
+            {
+                if (total_cost < _cells.get_g(id))
+                {
+                    _cells.open(id, total_cost, static_cast<uint8_t>(i));
+                    _open.decrease(id, total_cost + h[i], total_cost);
+                }
+            }
+            else
+            {
+                _cells.open(id, total_cost, static_cast<uint8_t>(i));
+                _open.push(id, total_cost + h[i], total_cost);
+            }
+        }
+    }
+    
+    _open.clear();
+    
+    int x = static_cast<int>(current) % width;
+    int y = static_cast<int>(current) / width;
+    
+    for (;;)
+    {
+        _path.push_back({ x, y });
+        
+        uint8_t parent = _cells.get_parent(static_cast<uint32_t>(y * width + x));
+        
+        if (parent == search_grid::no_parent)
+            break;
+        
+        x -= grid_direction_x[parent];
+        y -= grid_direction_y[parent];
+    }
+    
+    return expansions;
+}
+
+template<class heuristic_policy, class heap_type>
+inline std::size_t search_cells(
+      const occupancy_grid& _walls
+    , search_grid& _cells
+    , heap_type& _open
+    , vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , const heuristic_policy& _heuristic
+    , vector2_array_i& _path)
+{
+    if (_diagonal)
+        return search_cells<eight_neighbors>(_walls, _cells, _open, _start, _goal, _heuristic, _path);
+    
+    return search_cells<four_neighbors>(_walls, _cells, _open, _start, _goal, _heuristic, _path);
+}
+
+// Picks the specialized kernel for a heuristic and connectivity only known at 
+// runtime.  Euclidean reads _euclidean when it covers the world.
+template<class heap_type>
+std::size_t search_cells(
+      const occupancy_grid& _walls
+    , search_grid& _cells
+    , heap_type& _open
+    , vector2_i _start
+    , vector2_i _goal
+    , bool _diagonal
+    , heuristic_type _type
+    , const std::function<int(vector2_i, vector2_i)>& _heuristic
+    , const distance_table& _euclidean
+    , vector2_array_i& _path)
+{
+    switch (_type)
+    {
+        case heuristic_type::MANHATTAN:
+            return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, manhattan_policy(), _path);
+        case heuristic_type::OCTAGONAL:
+            return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, octagonal_policy(), _path);
+        case heuristic_type::EUCLIDEAN:
+            if (_euclidean.covers(_walls.get_size()))
+                return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, euclidean_table_policy{ _euclidean }, _path);
+            
+            return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, euclidean_policy(), _path);
+        case heuristic_type::LANDMARK:
+            if (const landmark_heuristic* landmarks = _heuristic.target<landmark_heuristic>())
+                return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, *landmarks, _path);
+            
+            return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, function_policy{ _heuristic }, _path);
+        default:
+            return search_cells(_walls, _cells, _open, _start, _goal, _diagonal, function_policy{ _heuristic }, _path);
+    }
+}
+
+#endif /* SEARCH_KERNEL_H */
@@ -0,0 +1,355 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tiled_grid.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char file_magic[8] = { 'T', 'I', 'L', 'E', 'G', 'R', 'I', 'D' };
+    const uint32_t file_version = 1;
+    
+    const int min_shift = 6;        // tile rows of at least one word
+    const int max_shift = 15;
+    
+    inline std::size_t page_size()
+    {
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+    
+    // Tiles needed to cover _cells cells
+    inline uint64_t tiles_across(int _cells, int _shift)
+    {
+        return (static_cast<uint64_t>(_cells) + (uint64_t(1) << _shift) - 1) >> _shift;
+    }
+}
+
+// Takes the first tile of the file, so that tiles start on a page
+struct tiled_grid::file_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t tile_shift;
+    uint64_t blocked;
+};
+
+const uint32_t tiled_grid::not_resident;
+
+tiled_grid::tiled_grid() :
+      fd(-1)
+    , header(nullptr)
+    , data(nullptr)
+    , mapped_bytes(0)
+    , tile_bytes(0)
+    , width(0)
+    , height(0)
+    , shift(0)
+    , mask(0)
+    , tiles_x(0)
+    , tiles_y(0)
+    , budget(1)
+    , resident(0)
+    , loads(0)
+    , evictions(0)
+    , last_tile(not_resident)
+    , last_bits(nullptr)
+{}
+
+tiled_grid::~tiled_grid()
+{
+    close();
+}
+
+bool tiled_grid::create(const std::string& _path, vector2_i _size, int _tile_size)
+{
+    int tile_shift = min_shift;
+    
+    while (tile_shift < max_shift && (1 << tile_shift) < _tile_size)
+        ++tile_shift;
+    
+    if (_size.x <= 0 || _size.y <= 0 || (1 << tile_shift) != _tile_size)
+        return false;
+    
+    const std::size_t bytes = (std::size_t(1) << (2 * tile_shift)) / 8;
+    const uint64_t tiles = tiles_across(_size.x, tile_shift) * tiles_across(_size.y, tile_shift);
+    
+    if (bytes % page_size() != 0 || tiles >= not_resident)
+        return false;
+    
+    int file = ::open(_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    
+    if (file < 0)
+        return false;
+    
+    file_header first;
+    std::memset(&first, 0, sizeof(first));
+    std::memcpy(first.magic, file_magic, sizeof(file_magic));
+    first.version = file_version;
+    first.width = static_cast<uint32_t>(_size.x);
+    first.height = static_cast<uint32_t>(_size.y);
+    first.tile_shift = static_cast<uint32_t>(tile_shift);
+    
+    // Growing the file leaves the tiles as holes that read as free cells
+    const bool written = pwrite(file, &first, sizeof(first), 0) == static_cast<ssize_t>(sizeof(first))
+        && ftruncate(file, static_cast<off_t>((tiles + 1) * bytes)) == 0;
+    
+    ::close(file);
+    
+    return written;
+}
+
+bool tiled_grid::open(const std::string& _path, std::size_t _tile_budget)
+{
+    close();
+    
+    int file = ::open(_path.c_str(), O_RDWR);
+    
+    if (file < 0)
+        return false;
+    
+    file_header first;
+    struct stat info;
+    
+    if (pread(file, &first, sizeof(first), 0) != static_cast<ssize_t>(sizeof(first)) 
+        || fstat(file, &info) != 0
+        || std::memcmp(first.magic, file_magic, sizeof(file_magic)) != 0 
+        || first.version != file_version
+        || first.width == 0 || first.width > INT32_MAX 
+        || first.height == 0 || first.height > INT32_MAX
+        || first.tile_shift < min_shift || first.tile_shift > max_shift)
+    {
+        ::close(file);
+        return false;
+    }
+    
+    const int tile_shift = static_cast<int>(first.tile_shift);
+    const std::size_t bytes = (std::size_t(1) << (2 * tile_shift)) / 8;
+    const uint64_t across = tiles_across(static_cast<int>(first.width), tile_shift);
+    const uint64_t down = tiles_across(static_cast<int>(first.height), tile_shift);
+    const uint64_t total = (across * down + 1) * bytes;
+    
+    // Tiles smaller than the pages of this machine cannot leave memory alone
+    if (bytes % page_size() != 0 || across * down >= not_resident 
+        || static_cast<uint64_t>(info.st_size) < total)
+    {
+        ::close(file);
+        return false;
+    }
+    
+    void* mapping = mmap(nullptr, static_cast<std::size_t>(total), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    
+    if (mapping == MAP_FAILED)
+    {
+        ::close(file);
+        return false;
+    }
+    
+    // Reading ahead would bring in tiles the search never touches
+    madvise(mapping, static_cast<std::size_t>(total), MADV_RANDOM);
+    
+    fd = file;
+    header = static_cast<file_header*>(mapping);
+    data = static_cast<uint8_t*>(mapping) + bytes;
+    mapped_bytes = static_cast<std::size_t>(total);
+    tile_bytes = bytes;
+    width = static_cast<int>(first.width);
+    height = static_cast<int>(first.height);
+    shift = tile_shift;
+    mask = (1 << tile_shift) - 1;
+    tiles_x = static_cast<uint32_t>(across);
+    tiles_y = static_cast<uint32_t>(down);
+    budget = std::max<std::size_t>(1, _tile_budget);
+    loads = 0;
+    evictions = 0;
+    reset_residency();
+    
+    return true;
+}
+
+void tiled_grid::close()
+{
+    if (!is_open())
+        return;
+    
+    munmap(header, mapped_bytes);
+    ::close(fd);
+    
+    fd = -1;
+    header = nullptr;
+    data = nullptr;
+    mapped_bytes = 0;
+    width = 0;
+    height = 0;
+    tiles_x = 0;
+    tiles_y = 0;
+    
+    newer.clear();
+    newer.shrink_to_fit();
+    older.clear();
+    older.shrink_to_fit();
+    resident = 0;
+    last_tile = not_resident;
+    last_bits = nullptr;
+}
+
+std::size_t tiled_grid::get_blocked_count() const
+{
+    return (header ? static_cast<std::size_t>(header->blocked) : 0);
+}
+
+void tiled_grid::set_tile_budget(std::size_t _tiles)
+{
+    budget = std::max<std::size_t>(1, _tiles);
+    
+    if (!is_open())
+        return;
+    
+    const uint32_t head = static_cast<uint32_t>(get_tile_count());
+    
+    while (resident > budget)
+        evict(newer[head]);
+}
+
+std::size_t tiled_grid::get_memory_usage() const
+{
+    return resident * tile_bytes + (newer.capacity() + older.capacity()) * sizeof(uint32_t);
+}
+
+bool tiled_grid::set(int _x, int _y)
+{
+    uint64_t& word = tile_bits(_x, _y)[local_bit(_x, _y) >> 6];
+    const uint64_t bit = uint64_t(1) << (local_bit(_x, _y) & 63);
+    
+    if (word & bit)
+        return false;
+    
+    word |= bit;
+    ++header->blocked;
+    
+    return true;
+}
+
+bool tiled_grid::reset(int _x, int _y)
+{
+    uint64_t& word = tile_bits(_x, _y)[local_bit(_x, _y) >> 6];
+    const uint64_t bit = uint64_t(1) << (local_bit(_x, _y) & 63);
+    
+    if (!(word & bit))
+        return false;
+    
+    word &= ~bit;
+    --header->blocked;
+    
+    return true;
+}
+
+void tiled_grid::clear()
+{
+    if (!is_open())
+        return;
+    
+    reset_residency();
+    header->blocked = 0;
+    
+    // Cutting the file back to its header and growing it again turns every 
+    // tile into a hole, which also drops the tiles from memory
+    if (ftruncate(fd, static_cast<off_t>(tile_bytes)) == 0 
+        && ftruncate(fd, static_cast<off_t>(mapped_bytes)) == 0)
+        return;
+    
+    for (std::size_t tile = 0; tile < get_tile_count(); ++tile)
+    {
+        std::memset(data + tile * tile_bytes, 0, tile_bytes);
+        madvise(data + tile * tile_bytes, tile_bytes, MADV_DONTNEED);
+    }
+}
+
+uint64_t* tiled_grid::touch(uint32_t _tile) const
+{
+    const uint32_t head = static_cast<uint32_t>(get_tile_count());
+    
+    if (older[_tile] == not_resident)
+    {
+        if (resident >= budget)
+            evict(newer[head]);
+        
+        ++resident;
+        ++loads;
+    }
+    else
+    {
+        unlink(_tile);
+    }
+    
+    const uint32_t first = older[head];
+    older[_tile] = first;
+    newer[_tile] = head;
+    newer[first] = _tile;
+    older[head] = _tile;
+    
+    last_tile = _tile;
+    last_bits = reinterpret_cast<uint64_t*>(data + static_cast<std::size_t>(_tile) * tile_bytes);
+    
+    return last_bits;
+}
+
+void tiled_grid::evict(uint32_t _tile) const
+{
+    unlink(_tile);
+    newer[_tile] = not_resident;
+    older[_tile] = not_resident;
+    --resident;
+    ++evictions;
+    
+    if (_tile == last_tile)
+        last_tile = not_resident;
+    
+    // The mapping is shared, so the file keeps what was written to the tile
+    madvise(data + static_cast<std::size_t>(_tile) * tile_bytes, tile_bytes, MADV_DONTNEED);
+}
+
+void tiled_grid::unlink(uint32_t _tile) const
+{
+    newer[older[_tile]] = newer[_tile];
+    older[newer[_tile]] = older[_tile];
+}
+
+void tiled_grid::reset_residency()
+{
+    const std::size_t head = get_tile_count();
+    
+    newer.assign(head + 1, not_resident);
+    older.assign(head + 1, not_resident);
+    newer[head] = static_cast<uint32_t>(head);
+    older[head] = static_cast<uint32_t>(head);
+    resident = 0;
+    last_tile = not_resident;
+    last_bits = nullptr;
+}
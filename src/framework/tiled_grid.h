@@ -0,0 +1,174 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TILED_GRID_H
+#define TILED_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <math/linear_algebra/vector.h>
+
+/*
+ * Bitmap of blocked cells in a memory-mapped file, cut into square tiles.
+ * 
+ * The file holds a header, then one row-major bitmap of whole pages per 
+ * tile.  Opening maps the file without reading it, so a world of any 
+ * size opens at once, and the system reads a tile in the first time a 
+ * search touches it.  At most the tile budget of tiles stay in memory: 
+ * touching one more drops the least recently used one, which the file 
+ * keeps, changes included.  A new file only stores the tiles written to.
+ * 
+ * A 100000 x 100000 world of 256 x 256 tiles is a 1.2 GB file of 8 KB 
+ * tiles, of which a budget of 1024 tiles keeps 8 MB in memory next to 
+ * 1.2 MB of tile bookkeeping.  Callers check that cells lie inside the 
+ * world.  Reading moves tiles in and out, so only one thread may use it.
+ */
+class tiled_grid
+{
+    
+public:
+    
+    explicit tiled_grid();
+    ~tiled_grid();
+    
+    tiled_grid(const tiled_grid&) = delete;
+    tiled_grid& operator=(const tiled_grid&) = delete;
+    
+    // Writes a world of _size free cells to _path.  _tile_size is a power 
+    // of two and its tiles must fill whole pages, 256 and up always do.
+    static bool create(const std::string& _path, vector2_i _size, int _tile_size = 256);
+    
+    // Maps the world _path was created with, false if it is not one
+    bool open(const std::string& _path, std::size_t _tile_budget);
+    void close();
+    
+    inline bool is_open() const { return header != nullptr; }
+    inline vector2_i get_size() const { return { width, height }; }
+    inline int get_tile_size() const { return 1 << shift; }
+    inline std::size_t get_tile_count() const { return static_cast<std::size_t>(tiles_x) * tiles_y; }
+    std::size_t get_blocked_count() const;
+    
+    // Drops the least recently used tiles beyond the new budget, at least 1
+    void set_tile_budget(std::size_t _tiles);
+    inline std::size_t get_tile_budget() const { return budget; }
+    
+    // Tiles in memory, and tiles read in and dropped since open
+    inline std::size_t get_resident_tiles() const { return resident; }
+    inline std::size_t get_tile_loads() const { return loads; }
+    inline std::size_t get_evictions() const { return evictions; }
+    
+    // Bytes of the tiles in memory and of the tile bookkeeping
+    std::size_t get_memory_usage() const;
+    
+    inline bool is_blocked(int _x, int _y) const
+    {
+        const uint32_t bit = local_bit(_x, _y);
+        return ((tile_bits(_x, _y)[bit >> 6] >> (bit & 63)) & 1) != 0;
+    }
+    
+    // Same bits as occupancy_grid::get_row_triple for cells inside the world
+    inline uint32_t get_row_triple(int _x, int _y) const
+    {
+        const int local_x = _x & mask;
+        
+        if (local_x == 0 || local_x == mask)
+        {
+            return static_cast<uint32_t>(is_blocked(_x - 1, _y)) 
+                | (static_cast<uint32_t>(is_blocked(_x, _y)) << 1) 
+                | (static_cast<uint32_t>(is_blocked(_x + 1, _y)) << 2);
+        }
+        
+        // Tile rows are whole words, so both words belong to row _y
+        const uint64_t* bits = tile_bits(_x, _y);
+        const uint32_t bit = local_bit(_x, _y) - 1;
+        const uint32_t offset = bit & 63;
+        uint64_t value = bits[bit >> 6] >> offset;
+        
+        if (offset > 61)
+            value |= bits[(bit >> 6) + 1] << (64 - offset);
+        
+        return static_cast<uint32_t>(value & 0x7);
+    }
+    
+    // Return whether the cell changed
+    bool set(int _x, int _y);
+    bool reset(int _x, int _y);
+    
+    // Frees every cell and gives the space of the tiles back to the file system
+    void clear();
+    
+private:
+    
+    static const uint32_t not_resident = UINT32_MAX;
+    
+    struct file_header;
+    
+    int fd;
+    file_header* header;                // start of the mapping
+    uint8_t* data;                      // first tile
+    std::size_t mapped_bytes;
+    std::size_t tile_bytes;
+    int width;
+    int height;
+    int shift;                          // log2 of the tile size
+    int mask;                           // tile size - 1
+    uint32_t tiles_x;
+    uint32_t tiles_y;
+    std::size_t budget;
+    
+    // Tiles in memory form a list from the most to the least recently used, 
+    // closed by the entry past the last tile
+    mutable std::vector<uint32_t> newer;
+    mutable std::vector<uint32_t> older;    // not_resident for tiles out of memory
+    mutable std::size_t resident;
+    mutable std::size_t loads;
+    mutable std::size_t evictions;
+    mutable uint32_t last_tile;             // tile of the last access, first in the list
+    mutable uint64_t* last_bits;
+    
+    inline uint32_t local_bit(int _x, int _y) const
+    {
+        return (static_cast<uint32_t>(_y & mask) << shift) | static_cast<uint32_t>(_x & mask);
+    }
+    
+    inline uint64_t* tile_bits(int _x, int _y) const
+    {
+        const uint32_t tile = static_cast<uint32_t>(_y >> shift) * tiles_x + static_cast<uint32_t>(_x >> shift);
+        return (tile == last_tile ? last_bits : touch(tile));
+    }
+    
+    // Makes _tile the most recently used, dropping the least recently used 
+    // tile when _tile is one over the budget
+    uint64_t* touch(uint32_t _tile) const;
+    
+    void evict(uint32_t _tile) const;
+    void unlink(uint32_t _tile) const;
+    
+    // Forgets which tiles are in memory
+    void reset_residency();
+    
+};
+
+#endif /* TILED_GRID_H */
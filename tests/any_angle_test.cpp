@@ -0,0 +1,154 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <random>
+#include <framework/line_of_sight.h>
+#include <framework/occupancy_grid.h>
+#include <framework/path_builder.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "any_angle_test"
+#include "test_support.h"
+
+namespace
+{
+    // Blocks the same random cells in _walls and _builder
+    void random_walls(occupancy_grid& _walls, path_builder& _builder, vector2_i _size, bool _diagonal, int _percent, unsigned _seed)
+    {
+        clear_world(_builder, _size, _diagonal);
+        _walls.resize(_size);
+        
+        std::mt19937 random(_seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        
+        for (int y = 0; y < _size.y; ++y)
+        {
+            for (int x = 0; x < _size.x; ++x)
+            {
+                if (percent(random) < _percent)
+                {
+                    _walls.set({ x, y });
+                    _builder.add_collision({ x, y });
+                }
+            }
+        }
+    }
+    
+    double length(const vector2_array_i& _path)
+    {
+        double total = 0.0;
+        
+        for (std::size_t i = 1; i < _path.size(); ++i)
+        {
+            const double dx = _path[i].x - _path[i - 1].x;
+            const double dy = _path[i].y - _path[i - 1].y;
+            total += std::sqrt(dx * dx + dy * dy);
+        }
+        
+        return total;
+    }
+    
+    // Whether _path joins the ends of _data with segments that see each other
+    bool is_visible_path(const occupancy_grid& _walls, const vector2_array_i& _path, const path_data& _data, bool _diagonal)
+    {
+        if (_path.empty() 
+            || _path.front() != static_cast<vector2_i>(_data.end_coordinate) 
+            || _path.back() != static_cast<vector2_i>(_data.start_coordinate))
+            return false;
+        
+        for (std::size_t i = 1; i < _path.size(); ++i)
+            if (!has_line_of_sight(_walls, _path[i - 1], _path[i], _diagonal))
+                return false;
+        
+        return true;
+    }
+    
+    void check_paths(const char* _test, search_mode _mode, bool _pull_string)
+    {
+        for (int percent : { 0, 15, 30 })
+        {
+            for (int diagonal = 0; diagonal < 2; ++diagonal)
+            {
+                occupancy_grid walls;
+                path_builder reference;
+                path_builder builder;
+                const unsigned seed = 171 + percent + diagonal;
+                
+                random_walls(walls, reference, { 64, 64 }, diagonal == 1, percent, seed);
+                random_walls(walls, builder, { 64, 64 }, diagonal == 1, percent, seed);
+                reference.set_search_backend(search_backend::CELL_ARRAYS);
+                builder.set_search_backend(search_backend::CELL_ARRAYS);
+                builder.set_search_mode(_mode);
+                
+                std::mt19937 random(seed + 1);
+                
+                for (int i = 0; i < 60; ++i)
+                {
+                    const path_data data = random_query(random, { 64, 64 });
+                    const vector2_array_i expected = reference.find_path(data);
+                    const vector2_array_i path = (_pull_string 
+                        ? builder.pull_string(builder.find_path(data)) 
+                        : builder.find_path(data));
+                    
+                    if (expected.empty() != path.empty())
+                        fail(_test, "reachability differs from A*");
+                    else if (!path.empty() && !is_visible_path(walls, path, data, diagonal == 1))
+                        fail(_test, "segment crosses a blocked cell");
+                    else if (length(path) > length(expected) + 1e-9)
+                        fail(_test, "path longer than the A* path");
+                }
+            }
+        }
+    }
+}
+
+// Theta* waypoints see each other and never make the path longer
+void test_theta_star()
+{
+    check_paths("test_theta_star", search_mode::ANY_ANGLE, false);
+}
+
+void test_lazy_theta_star()
+{
+    check_paths("test_lazy_theta_star", search_mode::LAZY_ANY_ANGLE, false);
+}
+
+// pull_string keeps A* paths visible from one waypoint to the next
+void test_pull_string()
+{
+    check_paths("test_pull_string", search_mode::ASTAR, true);
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_theta_star", test_theta_star);
+    run_test("test_lazy_theta_star", test_lazy_theta_star);
+    run_test("test_pull_string", test_pull_string);
+    
+    return finish_suite();
+}
@@ -0,0 +1,94 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <framework/anytime_search.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "anytime_search_test"
+#include "test_support.h"
+
+// Calls cut short in the middle of a pass still report the cost of the path they return
+void test_cost_of_interrupted_passes()
+{
+    occupancy_grid walls;
+    walls.resize({ 256, 256 });
+    
+    std::mt19937 random(3);
+    std::uniform_int_distribution<int> coordinate(0, 255);
+    
+    for (int i = 0; i < 16000; ++i)
+        walls.set({ coordinate(random), coordinate(random) });
+    
+    anytime_search search(walls);
+    int calls = 0;
+    
+    for (int query = 0; query < 20; ++query)
+    {
+        const vector2_i start = { coordinate(random), coordinate(random) };
+        const vector2_i goal = { coordinate(random), coordinate(random) };
+        const bool diagonal = (query % 2 == 0);
+        const std::function<int(vector2_i, vector2_i)> heuristic = 
+            (diagonal ? path_builder::octagonal : path_builder::manhattan);
+        
+        // Repeating the query resumes the passes until the path is optimal
+        for (int call = 0; call < 400; ++call)
+        {
+            const auto deadline = anytime_search::clock::now() + std::chrono::microseconds(20);
+            const vector2_array_i path = search.find_path(start, goal, diagonal, heuristic, deadline);
+            
+            if (path.empty())
+            {
+                if (search.get_cost() != -1)
+                    fail("test_cost_of_interrupted_passes", "cost without a path");
+                
+                continue;
+            }
+            
+            ++calls;
+            
+            if (path.front() != static_cast<vector2_i>(goal) || path.back() != static_cast<vector2_i>(start))
+                fail("test_cost_of_interrupted_passes", "path does not join start and goal");
+            
+            if (search.get_cost() != path_cost(path))
+                fail("test_cost_of_interrupted_passes", "reported cost differs from the path");
+            
+            if (search.get_bound() == 1.0)
+                break;
+        }
+    }
+    
+    if (calls == 0)
+        fail("test_cost_of_interrupted_passes", "no path found");
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_cost_of_interrupted_passes", test_cost_of_interrupted_passes);
+    
+    return finish_suite();
+}
@@ -0,0 +1,92 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "bidirectional_search_test"
+#include "test_support.h"
+
+// Meeting frontiers stop at the optimal cost, not at the first cell they share
+void test_optimal_paths()
+{
+    for (int percent : { 0, 15, 30, 40 })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            path_builder reference;
+            path_builder bidirectional;
+            const unsigned seed = 89 + percent + diagonal;
+            
+            random_world(reference, { 64, 64 }, diagonal == 1, percent, seed);
+            random_world(bidirectional, { 64, 64 }, diagonal == 1, percent, seed);
+            reference_astar(reference);
+            bidirectional.set_search_mode(search_mode::BIDIRECTIONAL);
+            
+            compare_paths("test_optimal_paths", reference, bidirectional, diagonal == 1, 100, seed + 1);
+        }
+    }
+}
+
+// A start and goal in dead ends, where the frontiers touch late
+void test_dead_ends()
+{
+    path_builder reference;
+    path_builder bidirectional;
+    
+    clear_world(reference, { 40, 40 }, true);
+    clear_world(bidirectional, { 40, 40 }, true);
+    reference_astar(reference);
+    bidirectional.set_search_mode(search_mode::BIDIRECTIONAL);
+    
+    // Two cups opening away from each other
+    for (int i = 0; i < 12; ++i)
+    {
+        for (path_builder* builder : { &reference, &bidirectional })
+        {
+            builder->add_collision({ 5 + i, 10 });
+            builder->add_collision({ 5 + i, 22 });
+            builder->add_collision({ 16, 10 + i });
+            builder->add_collision({ 23 + i, 17 });
+            builder->add_collision({ 23 + i, 29 });
+            builder->add_collision({ 23, 17 + i });
+        }
+    }
+    
+    const path_data data = query({ 12, 16 }, { 28, 23 });
+    const vector2_array_i expected = reference.find_path(data);
+    const vector2_array_i path = bidirectional.find_path(data);
+    
+    if (expected.empty() || path_cost(path) != path_cost(expected) || !is_connected_path(path, data, true))
+        fail("test_dead_ends", "path differs from the reference A*");
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_optimal_paths", test_optimal_paths);
+    run_test("test_dead_ends", test_dead_ends);
+    
+    return finish_suite();
+}
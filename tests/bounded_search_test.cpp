@@ -0,0 +1,110 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "bounded_search_test"
+#include "test_support.h"
+
+namespace
+{
+    const double epsilons[] = { 0.2, 0.5 };
+    
+    // Paths of _mode against A* on the same queries, with the reported bound 
+    // at least the real ratio and at most 1 + _epsilon
+    void check_bound(const char* _test, search_mode _mode, double _epsilon, bool _diagonal)
+    {
+        path_builder optimal;
+        path_builder bounded;
+        
+        random_world(optimal, { 128, 128 }, _diagonal, 25, 5);
+        random_world(bounded, { 128, 128 }, _diagonal, 25, 5);
+        bounded.set_search_mode(_mode);
+        bounded.set_suboptimality(_epsilon);
+        
+        const double limit = 1.0 + _epsilon;
+        std::mt19937 random(17);
+        
+        for (int i = 0; i < 100; ++i)
+        {
+            const path_data data = random_query(random, { 128, 128 });
+            const vector2_array_i expected = optimal.find_path(data);
+            const vector2_array_i path = bounded.find_path(data);
+            
+            if (expected.empty() != path.empty())
+            {
+                fail(_test, "reachability differs from A*");
+                continue;
+            }
+            
+            if (path.empty())
+                continue;
+            
+            const int best = path_cost(expected);
+            const int cost = path_cost(path);
+            
+            if (bounded.get_path_cost() != cost)
+                fail(_test, "reported cost differs from the path");
+            
+            if (best > 0 && cost > limit * best + 1e-9)
+                fail(_test, "path over the guaranteed bound");
+            
+            if (best > 0 && static_cast<double>(cost) / best > bounded.get_suboptimality_bound() + 1e-9)
+                fail(_test, "path over the reported bound");
+            
+            if (bounded.get_suboptimality_bound() > limit + 1e-9)
+                fail(_test, "reported bound over the guaranteed one");
+        }
+    }
+}
+
+void test_weighted_bound()
+{
+    for (double epsilon : epsilons)
+    {
+        check_bound("test_weighted_bound", search_mode::WEIGHTED, epsilon, false);
+        check_bound("test_weighted_bound", search_mode::WEIGHTED, epsilon, true);
+    }
+}
+
+void test_focal_bound()
+{
+    for (double epsilon : epsilons)
+    {
+        check_bound("test_focal_bound", search_mode::FOCAL, epsilon, false);
+        check_bound("test_focal_bound", search_mode::FOCAL, epsilon, true);
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_weighted_bound", test_weighted_bound);
+    run_test("test_focal_bound", test_focal_bound);
+    
+    return finish_suite();
+}
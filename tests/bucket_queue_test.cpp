@@ -0,0 +1,155 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <map>
+#include <random>
+#include <framework/bucket_queue.h>
+#include <framework/path_builder.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "bucket_queue_test"
+#include "test_support.h"
+
+// Pops come out by lowest f through pushes, key changes and removals, 
+// checked against a map of the queued cells
+void test_pop_order()
+{
+    bucket_queue<int32_t> queue;
+    std::map<uint32_t, int32_t> queued;
+    std::mt19937 random(71);
+    std::uniform_int_distribution<uint32_t> cell(0, 499);
+    std::uniform_int_distribution<int32_t> f(0, 300);
+    std::uniform_int_distribution<int> action(0, 9);
+    
+    queue.reset(500);
+    
+    for (int step = 0; step < 20000; ++step)
+    {
+        const uint32_t id = cell(random);
+        const int choice = action(random);
+        
+        if (choice < 4 && !queue.contains(id))
+        {
+            const int32_t key = f(random);
+            queue.push(id, key, 0);
+            queued[id] = key;
+        }
+        else if (choice < 6 && queue.contains(id))
+        {
+            // Raising f as well, which inconsistent heuristics do
+            const int32_t key = f(random);
+            queue.update(id, key, 0);
+            queued[id] = key;
+        }
+        else if (choice < 7 && queue.contains(id))
+        {
+            queue.remove(id);
+            queued.erase(id);
+        }
+        else if (!queue.empty())
+        {
+            int32_t lowest = INT32_MAX;
+            
+            for (const auto& item : queued)
+                lowest = std::min(lowest, item.second);
+            
+            const int32_t top = queue.top_f();
+            const uint32_t popped = queue.pop();
+            
+            if (top != lowest || queued.count(popped) == 0 || queued[popped] != lowest)
+            {
+                fail("test_pop_order", "pop did not take a cell of the lowest f");
+                return;
+            }
+            
+            queued.erase(popped);
+        }
+        
+        if (queue.size() != queued.size())
+        {
+            fail("test_pop_order", "size differs from the cells queued");
+            return;
+        }
+    }
+}
+
+// Clearing forgets every cell, and the queue works again afterwards
+void test_clear()
+{
+    bucket_queue<int32_t> queue;
+    queue.reset(100);
+    
+    for (uint32_t id = 0; id < 100; ++id)
+        queue.push(id, static_cast<int32_t>((id * 37) % 50), 0);
+    
+    queue.pop();
+    queue.clear();
+    
+    if (!queue.empty() || queue.size() != 0)
+        fail("test_clear", "cells left after clear");
+    
+    for (uint32_t id = 0; id < 100; ++id)
+        if (queue.contains(id))
+            fail("test_clear", "cell still queued after clear");
+    
+    queue.push(7, 40, 0);
+    queue.push(8, 3, 0);
+    
+    if (queue.pop() != 8 || queue.pop() != 7 || !queue.empty())
+        fail("test_clear", "wrong order after clear");
+}
+
+// BUCKET_QUEUE paths cost what the reference A* finds
+void test_optimal_paths()
+{
+    for (int percent : { 0, 15, 30, 40 })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            path_builder reference;
+            path_builder buckets;
+            const unsigned seed = 151 + percent + diagonal;
+            
+            random_world(reference, { 64, 64 }, diagonal == 1, percent, seed);
+            random_world(buckets, { 64, 64 }, diagonal == 1, percent, seed);
+            reference_astar(reference);
+            buckets.set_search_backend(search_backend::CELL_ARRAYS);
+            buckets.set_open_list(open_list_type::BUCKET_QUEUE);
+            
+            compare_paths("test_optimal_paths", reference, buckets, diagonal == 1, 100, seed + 1);
+        }
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_pop_order", test_pop_order);
+    run_test("test_clear", test_clear);
+    run_test("test_optimal_paths", test_optimal_paths);
+    
+    return finish_suite();
+}
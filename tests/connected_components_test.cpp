@@ -0,0 +1,237 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <map>
+#include <random>
+#include <vector>
+#include <framework/connected_components.h>
+#include <framework/occupancy_grid.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "connected_components_test"
+#include "test_support.h"
+
+namespace
+{
+    void random_walls(occupancy_grid& _walls, vector2_i _size, int _percent, unsigned _seed)
+    {
+        _walls.resize(_size);
+        
+        std::mt19937 random(_seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        
+        for (int y = 0; y < _size.y; ++y)
+            for (int x = 0; x < _size.x; ++x)
+                if (percent(random) < _percent)
+                    _walls.set({ x, y });
+    }
+    
+    // Region of every cell from a plain flood fill, -1 on blocked cells
+    std::vector<int> flood_regions(const occupancy_grid& _walls, bool _diagonal)
+    {
+        static const int dx[] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+        static const int dy[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+        
+        const vector2_i size = _walls.get_size();
+        std::vector<int> regions(static_cast<std::size_t>(size.x) * size.y, -1);
+        std::vector<vector2_i> open;
+        int count = 0;
+        
+        for (int y = 0; y < size.y; ++y)
+        {
+            for (int x = 0; x < size.x; ++x)
+            {
+                if (_walls.is_blocked(x, y) || regions[y * size.x + x] != -1)
+                    continue;
+                
+                regions[y * size.x + x] = count;
+                open.push_back({ x, y });
+                
+                while (!open.empty())
+                {
+                    const vector2_i cell = open.back();
+                    open.pop_back();
+                    
+                    for (int i = 0; i < (_diagonal ? 8 : 4); ++i)
+                    {
+                        const int nx = cell.x + dx[i];
+                        const int ny = cell.y + dy[i];
+                        
+                        if (nx < 0 || ny < 0 || nx >= size.x || ny >= size.y 
+                            || _walls.is_blocked(nx, ny) || regions[ny * size.x + nx] != -1)
+                            continue;
+                        
+                        regions[ny * size.x + nx] = count;
+                        open.push_back({ nx, ny });
+                    }
+                }
+                
+                ++count;
+            }
+        }
+        
+        return regions;
+    }
+    
+    // Whether the labels split the free cells exactly like the flood fill
+    bool same_regions(const connected_components& _components, const occupancy_grid& _walls, bool _diagonal)
+    {
+        const std::vector<int> regions = flood_regions(_walls, _diagonal);
+        const vector2_i size = _walls.get_size();
+        std::map<uint32_t, int> region_of_label;
+        std::map<int, uint32_t> label_of_region;
+        
+        for (int y = 0; y < size.y; ++y)
+        {
+            for (int x = 0; x < size.x; ++x)
+            {
+                const uint32_t label = _components.get_label({ x, y });
+                const int region = regions[y * size.x + x];
+                
+                if ((label == connected_components::none) != (region == -1))
+                    return false;
+                
+                if (region == -1)
+                    continue;
+                
+                if (region_of_label.emplace(label, region).first->second != region 
+                    || label_of_region.emplace(region, label).first->second != label)
+                    return false;
+            }
+        }
+        
+        return true;
+    }
+}
+
+// A full labeling matches the flood fill with either movement
+void test_labels()
+{
+    for (int percent : { 0, 20, 35, 45, 60 })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            occupancy_grid walls;
+            random_walls(walls, { 70, 45 }, percent, 3 + percent);
+            
+            connected_components components(walls);
+            components.update(diagonal == 1);
+            
+            if (!same_regions(components, walls, diagonal == 1))
+                fail("test_labels", "labels differ from the flood fill");
+        }
+    }
+}
+
+// Labels stay right through single changes, which split and join regions
+void test_single_changes()
+{
+    for (int diagonal = 0; diagonal < 2; ++diagonal)
+    {
+        occupancy_grid walls;
+        random_walls(walls, { 40, 40 }, 40, 21 + diagonal);
+        
+        connected_components components(walls);
+        components.update(diagonal == 1);
+        
+        std::mt19937 random(22 + diagonal);
+        std::uniform_int_distribution<int> coordinate(0, 39);
+        
+        for (int i = 0; i < 600; ++i)
+        {
+            const vector2_i cell = { coordinate(random), coordinate(random) };
+            
+            if (walls.is_blocked(cell))
+            {
+                if (walls.reset(cell))
+                    components.unblock(cell);
+            }
+            else if (walls.set(cell))
+            {
+                components.block(cell);
+            }
+            
+            components.update(diagonal == 1);
+            
+            if (!same_regions(components, walls, diagonal == 1))
+            {
+                fail("test_single_changes", "labels differ from the flood fill after a change");
+                return;
+            }
+        }
+        
+        // Far fewer cells flooded again than a full labeling per change
+        if (components.get_relabeled_cells() >= 600u * 40 * 40 / 4)
+            fail("test_single_changes", "changes relabeled most of the world");
+    }
+}
+
+// Batches of changes and a change of movement between updates
+void test_batches()
+{
+    occupancy_grid walls;
+    random_walls(walls, { 64, 48 }, 35, 31);
+    
+    connected_components components(walls);
+    std::mt19937 random(32);
+    std::uniform_int_distribution<int> x(0, 63);
+    std::uniform_int_distribution<int> y(0, 47);
+    
+    for (int batch = 0; batch < 40; ++batch)
+    {
+        const bool diagonal = (batch % 3 == 0);
+        
+        for (int i = 0; i < 1 + batch * 5; ++i)
+        {
+            const vector2_i cell = { x(random), y(random) };
+            
+            if (walls.is_blocked(cell))
+            {
+                if (walls.reset(cell))
+                    components.unblock(cell);
+            }
+            else if (walls.set(cell))
+            {
+                components.block(cell);
+            }
+        }
+        
+        components.update(diagonal);
+        
+        if (!same_regions(components, walls, diagonal))
+            fail("test_batches", "labels differ from the flood fill after a batch");
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_labels", test_labels);
+    run_test("test_single_changes", test_single_changes);
+    run_test("test_batches", test_batches);
+    
+    return finish_suite();
+}
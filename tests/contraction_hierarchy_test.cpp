@@ -0,0 +1,125 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "contraction_hierarchy_test"
+#include "test_support.h"
+
+namespace
+{
+    // 64 x 64 world with diagonal movement and a fifth of its cells blocked, 
+    // the corner (0, 0) always and the corner (63, 63) never
+    void corner_world(path_builder& _builder)
+    {
+        random_world(_builder, { 64, 64 }, true, 20, 17);
+        _builder.add_collision({ 0, 0 });
+        _builder.remove_collision({ 63, 63 });
+    }
+    
+    // Paths of the contraction mode cost what A* paths cost
+    bool same_costs(path_builder& _contraction, path_builder& _astar, unsigned _seed)
+    {
+        std::mt19937 random(_seed);
+        
+        for (int i = 0; i < 50; ++i)
+        {
+            const path_data data = random_query(random, { 64, 64 });
+            const vector2_array_i expected = _astar.find_path(data);
+            const vector2_array_i path = _contraction.find_path(data);
+            
+            if (expected.empty() != path.empty() || path_cost(path) != path_cost(expected))
+                return false;
+        }
+        
+        return true;
+    }
+}
+
+void test_explicit_build()
+{
+    path_builder contraction;
+    path_builder astar;
+    corner_world(contraction);
+    corner_world(astar);
+    contraction.set_search_mode(search_mode::CONTRACTION);
+    
+    // Queries before the build search like A* and start no build
+    if (!same_costs(contraction, astar, 1))
+        fail("test_explicit_build", "unbuilt contraction mode differs from A*");
+    
+    if (contraction.get_contraction_hierarchy().is_built(true))
+        fail("test_explicit_build", "query built the hierarchy");
+    
+    contraction.build_contraction_hierarchy();
+    
+    if (!contraction.get_contraction_hierarchy().is_built(true))
+        fail("test_explicit_build", "hierarchy not built");
+    
+    if (!same_costs(contraction, astar, 2))
+        fail("test_explicit_build", "contraction paths differ from A*");
+}
+
+void test_collision_changes()
+{
+    path_builder contraction;
+    path_builder astar;
+    corner_world(contraction);
+    corner_world(astar);
+    contraction.set_search_mode(search_mode::CONTRACTION);
+    contraction.build_contraction_hierarchy();
+    
+    // Writes that change no cell keep the hierarchy
+    contraction.add_collision({ 0, 0 });
+    contraction.remove_collision({ 63, 63 });
+    contraction.add_collision({ -5, 3 });
+    
+    if (!contraction.get_contraction_hierarchy().is_built(true))
+        fail("test_collision_changes", "write that changed no cell dropped the hierarchy");
+    
+    // A real change drops it, and queries fall back to A* until the next build
+    contraction.add_collision({ 63, 63 });
+    astar.add_collision({ 63, 63 });
+    
+    if (contraction.get_contraction_hierarchy().is_built(true))
+        fail("test_collision_changes", "collision change kept the hierarchy");
+    
+    if (!same_costs(contraction, astar, 3))
+        fail("test_collision_changes", "paths after the change differ from A*");
+    
+    if (contraction.get_contraction_hierarchy().is_built(true))
+        fail("test_collision_changes", "query rebuilt the hierarchy");
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_explicit_build", test_explicit_build);
+    run_test("test_collision_changes", test_collision_changes);
+    
+    return finish_suite();
+}
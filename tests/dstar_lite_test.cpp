@@ -0,0 +1,137 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "dstar_lite_test"
+#include "test_support.h"
+
+namespace
+{
+    // An agent walks toward a fixed goal, one cell per step, while cells 
+    // change around it, and every replan is checked against a new A* search
+    void walk(const char* _test, bool _diagonal, int _changes, unsigned _seed)
+    {
+        path_builder reference;
+        path_builder incremental;
+        
+        random_world(reference, { 64, 64 }, _diagonal, 20, _seed);
+        random_world(incremental, { 64, 64 }, _diagonal, 20, _seed);
+        reference_astar(reference);
+        incremental.set_search_mode(search_mode::INCREMENTAL);
+        
+        std::mt19937 random(_seed + 1);
+        std::uniform_int_distribution<int> coordinate(0, 63);
+        int walks = 0;
+        
+        while (walks < 3)
+        {
+            path_data data = random_query(random, { 64, 64 });
+            
+            if (reference.find_path(data).size() < 20)
+                continue;
+            
+            ++walks;
+            
+            for (int step = 0; step < 30; ++step)
+            {
+                const vector2_array_i expected = reference.find_path(data);
+                const vector2_array_i path = incremental.find_path(data);
+                
+                if (expected.empty() != path.empty() || path_cost(path) != path_cost(expected))
+                {
+                    fail(_test, "replanned path differs from the reference A*");
+                    break;
+                }
+                
+                if (path.size() < 2 || !is_connected_path(path, data, _diagonal))
+                    break;
+                
+                // One step along the path, whichever end it lists first
+                data.start_coordinate = (path.back() == static_cast<vector2_i>(data.start_coordinate) 
+                    ? path[path.size() - 2] : path[1]);
+                
+                for (int i = 0; i < _changes; ++i)
+                {
+                    const vector2_i cell = { coordinate(random), coordinate(random) };
+                    
+                    if (cell == static_cast<vector2_i>(data.start_coordinate) 
+                        || cell == static_cast<vector2_i>(data.end_coordinate))
+                        continue;
+                    
+                    if (i % 2 == 0)
+                    {
+                        reference.add_collision(cell);
+                        incremental.add_collision(cell);
+                    }
+                    else
+                    {
+                        reference.remove_collision(cell);
+                        incremental.remove_collision(cell);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_replans_after_changes()
+{
+    walk("test_replans_after_changes", false, 1, 101);
+    walk("test_replans_after_changes", false, 16, 103);
+    walk("test_replans_after_changes", true, 16, 107);
+}
+
+// A change of goal or movement starts the search over
+void test_new_goal_and_movement()
+{
+    path_builder reference;
+    path_builder incremental;
+    
+    random_world(reference, { 64, 64 }, false, 25, 109);
+    random_world(incremental, { 64, 64 }, false, 25, 109);
+    reference_astar(reference);
+    incremental.set_search_mode(search_mode::INCREMENTAL);
+    
+    compare_paths("test_new_goal_and_movement", reference, incremental, false, 50, 113);
+    
+    reference.set_diagonal_movement(true);
+    reference.set_heuristic(path_builder::octagonal);
+    incremental.set_diagonal_movement(true);
+    incremental.set_heuristic(path_builder::octagonal);
+    
+    compare_paths("test_new_goal_and_movement", reference, incremental, true, 50, 127);
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_replans_after_changes", test_replans_after_changes);
+    run_test("test_new_goal_and_movement", test_new_goal_and_movement);
+    
+    return finish_suite();
+}
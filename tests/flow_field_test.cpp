@@ -0,0 +1,143 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <framework/path_builder.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "flow_field_test"
+#include "test_support.h"
+
+// Paths read from the field cost what the reference A* finds
+void test_optimal_paths()
+{
+    for (int percent : { 0, 15, 30, 40 })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            path_builder reference;
+            path_builder field;
+            const unsigned seed = 131 + percent + diagonal;
+            
+            random_world(reference, { 48, 48 }, diagonal == 1, percent, seed);
+            random_world(field, { 48, 48 }, diagonal == 1, percent, seed);
+            reference_astar(reference);
+            field.set_search_mode(search_mode::FLOW_FIELD);
+            
+            compare_paths("test_optimal_paths", reference, field, diagonal == 1, 60, seed + 1);
+        }
+    }
+}
+
+// Queries to the goal of the last one reuse its field
+void test_shared_goal()
+{
+    path_builder reference;
+    path_builder field;
+    
+    random_world(reference, { 64, 64 }, true, 25, 7);
+    random_world(field, { 64, 64 }, true, 25, 7);
+    reference_astar(reference);
+    field.set_search_mode(search_mode::FLOW_FIELD);
+    
+    std::mt19937 random(8);
+    const vector2_i goal = random_query(random, { 64, 64 }).end_coordinate;
+    
+    for (int i = 0; i < 50; ++i)
+    {
+        const path_data data = query(random_query(random, { 64, 64 }).start_coordinate, goal);
+        const vector2_array_i expected = reference.find_path(data);
+        const vector2_array_i path = field.find_path(data);
+        
+        if (expected.empty() != path.empty() || path_cost(path) != path_cost(expected))
+            fail("test_shared_goal", "path cost differs from the reference A*");
+        
+        if (i > 0 && field.get_expansions() != 0)
+            fail("test_shared_goal", "field rebuilt for the same goal");
+    }
+}
+
+// Collisions added and removed on the path make the next use rebuild the field
+void test_collision_change()
+{
+    path_builder reference;
+    path_builder field;
+    
+    clear_world(reference, { 32, 32 }, false);
+    clear_world(field, { 32, 32 }, false);
+    reference_astar(reference);
+    field.set_search_mode(search_mode::FLOW_FIELD);
+    
+    const path_data data = query({ 2, 16 }, { 29, 16 });
+    
+    if (path_cost(field.find_path(data)) != 270)
+        fail("test_collision_change", "wrong cost on open ground");
+    
+    // A wall across the straight line with one gap near the top
+    for (int y = 4; y < 32; ++y)
+    {
+        reference.add_collision({ 15, y });
+        field.add_collision({ 15, y });
+    }
+    
+    const vector2_array_i expected = reference.find_path(data);
+    const vector2_array_i path = field.find_path(data);
+    
+    if (field.get_expansions() == 0)
+        fail("test_collision_change", "field reused after a collision change");
+    
+    if (path_cost(path) != path_cost(expected) || !is_connected_path(path, data, false))
+        fail("test_collision_change", "path differs from the reference A* after a collision change");
+    
+    for (const vector2_i& cell : path)
+        if (cell.x == 15 && cell.y >= 4)
+            fail("test_collision_change", "path crosses the new wall");
+    
+    // Walking the field cell by cell follows a path of the same cost
+    vector2_array_i walked = { data.start_coordinate };
+    
+    while (walked.back() != static_cast<vector2_i>(data.end_coordinate) && walked.size() < 1024)
+        walked.push_back(field.get_next_step(walked.back(), data.end_coordinate));
+    
+    if (path_cost(walked) != path_cost(expected))
+        fail("test_collision_change", "walking the field costs more than the reference A*");
+    
+    for (int y = 4; y < 32; ++y)
+        field.remove_collision({ 15, y });
+    
+    if (path_cost(field.find_path(data)) != 270)
+        fail("test_collision_change", "field kept the removed wall");
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_optimal_paths", test_optimal_paths);
+    run_test("test_shared_goal", test_shared_goal);
+    run_test("test_collision_change", test_collision_change);
+    
+    return finish_suite();
+}
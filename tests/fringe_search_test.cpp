@@ -0,0 +1,180 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <vector>
+#include <framework/path_builder.h>
+#include <parallel/thread_pool.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "fringe_search_test"
+#include "test_support.h"
+
+namespace
+{
+    // Walls across the world from alternate sides, with a gap at the end 
+    // of each, so that paths wind and the threshold rises many times
+    void comb_world(path_builder& _builder, vector2_i _size, bool _diagonal)
+    {
+        clear_world(_builder, _size, _diagonal);
+        
+        for (int y = 2; y < _size.y; y += 4)
+        {
+            const bool from_left = ((y / 4) % 2 == 0);
+            
+            for (int x = 0; x < _size.x - 2; ++x)
+                _builder.add_collision({ from_left ? x : _size.x - 1 - x, y });
+        }
+    }
+}
+
+// FRINGE paths cost what the reference A* finds
+void test_optimal_paths()
+{
+    for (int percent : { 0, 15, 30, 40 })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            path_builder reference;
+            path_builder fringe;
+            const unsigned seed = 181 + percent + diagonal;
+            
+            random_world(reference, { 64, 64 }, diagonal == 1, percent, seed);
+            random_world(fringe, { 64, 64 }, diagonal == 1, percent, seed);
+            reference_astar(reference);
+            fringe.set_search_backend(search_backend::CELL_ARRAYS);
+            fringe.set_search_mode(search_mode::FRINGE);
+            
+            compare_paths("test_optimal_paths", reference, fringe, diagonal == 1, 100, seed + 1);
+        }
+    }
+}
+
+// Winding corridors, where the heuristic is poor and there are many sweeps
+void test_winding_paths()
+{
+    for (int diagonal = 0; diagonal < 2; ++diagonal)
+    {
+        path_builder reference;
+        path_builder fringe;
+        
+        comb_world(reference, { 40, 60 }, diagonal == 1);
+        comb_world(fringe, { 40, 60 }, diagonal == 1);
+        reference_astar(reference);
+        fringe.set_search_mode(search_mode::FRINGE);
+        
+        compare_paths("test_winding_paths", reference, fringe, diagonal == 1, 60, 191 + diagonal);
+    }
+}
+
+// Heuristics the search kernel does not know run through std::function 
+// and find the same costs, with the ones that never overestimate
+void test_custom_heuristic()
+{
+    typedef int (*heuristic_function)(vector2_i, vector2_i);
+    
+    for (heuristic_function builtin : { path_builder::manhattan, path_builder::octagonal, path_builder::euclidean })
+    {
+        // Manhattan overestimates diagonal moves
+        for (int diagonal = 0; diagonal < (builtin == path_builder::manhattan ? 1 : 2); ++diagonal)
+        {
+            path_builder reference;
+            path_builder fringe;
+            const unsigned seed = 193 + diagonal;
+            
+            random_world(reference, { 70, 50 }, diagonal == 1, 25, seed);
+            random_world(fringe, { 70, 50 }, diagonal == 1, 25, seed);
+            reference_astar(reference);
+            fringe.set_search_mode(search_mode::FRINGE);
+            fringe.set_heuristic([builtin](vector2_i _a, vector2_i _b) { return builtin(_a, _b); });
+            
+            compare_paths("test_custom_heuristic", reference, fringe, diagonal == 1, 40, seed + 1);
+        }
+    }
+}
+
+// A goal walled in has no path, and a start on the goal is a path of one cell
+void test_unreachable_goal()
+{
+    path_builder fringe;
+    clear_world(fringe, { 20, 20 }, true);
+    fringe.set_search_mode(search_mode::FRINGE);
+    
+    for (int y = 9; y <= 11; ++y)
+        for (int x = 9; x <= 11; ++x)
+            if (x != 10 || y != 10)
+                fringe.add_collision({ x, y });
+    
+    if (!fringe.find_path(query({ 1, 1 }, { 10, 10 })).empty())
+        fail("test_unreachable_goal", "path into a walled cell");
+    
+    if (fringe.find_path(query({ 10, 10 }, { 10, 10 })).size() != 1)
+        fail("test_unreachable_goal", "start on the goal is not a path of one cell");
+}
+
+// find_paths batches cost what the reference A* finds one query at a time
+void test_batch_paths()
+{
+    path_builder reference;
+    path_builder fringe;
+    
+    random_world(reference, { 64, 64 }, true, 25, 197);
+    random_world(fringe, { 64, 64 }, true, 25, 197);
+    reference_astar(reference);
+    fringe.set_search_mode(search_mode::FRINGE);
+    
+    std::mt19937 random(198);
+    std::vector<path_data> queries;
+    
+    for (int i = 0; i < 64; ++i)
+        queries.push_back(random_query(random, { 64, 64 }));
+    
+    std::vector<vector2_array_i> results(queries.size());
+    thread_pool pool(2);
+    fringe.find_paths(queries.data(), queries.size(), results.data(), pool, 3);
+    
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        const vector2_array_i expected = reference.find_path(queries[i]);
+        
+        if (expected.empty() != results[i].empty())
+            fail("test_batch_paths", "reachability differs from the reference A*");
+        else if (path_cost(results[i]) != path_cost(expected))
+            fail("test_batch_paths", "path cost differs from the reference A*");
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_optimal_paths", test_optimal_paths);
+    run_test("test_winding_paths", test_winding_paths);
+    run_test("test_custom_heuristic", test_custom_heuristic);
+    run_test("test_unreachable_goal", test_unreachable_goal);
+    run_test("test_batch_paths", test_batch_paths);
+    
+    return finish_suite();
+}
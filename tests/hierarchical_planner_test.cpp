@@ -0,0 +1,211 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <limits>
+#include <random>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "hierarchical_planner_test"
+#include "test_support.h"
+
+namespace
+{
+    const double epsilons[] = { 0.2, 0.5 };
+    
+    // Checks a hierarchical path against the A* path of the same query: the 
+    // cost it reports, its bound and 1 + _epsilon, infinite without the guarantee
+    void check_path(
+          const char* _test
+        , const path_builder& _hierarchical
+        , const vector2_array_i& _path
+        , const vector2_array_i& _expected
+        , double _epsilon)
+    {
+        if (_expected.empty() != _path.empty())
+        {
+            fail(_test, "reachability differs from A*");
+            return;
+        }
+        
+        if (_path.empty())
+            return;
+        
+        const int best = path_cost(_expected);
+        const int cost = path_cost(_path);
+        const double bound = _hierarchical.get_suboptimality_bound();
+        
+        if (_hierarchical.get_path_cost() != cost)
+            fail(_test, "reported cost differs from the path");
+        
+        if (cost > (1.0 + _epsilon) * best + 1e-9)
+            fail(_test, "path over the guaranteed bound");
+        
+        if (best > 0 && static_cast<double>(cost) / best > bound + 1e-9)
+            fail(_test, "path over the reported bound");
+        
+        if (bound > 1.0 + _epsilon + 1e-9)
+            fail(_test, "reported bound over the guaranteed one");
+    }
+    
+    // Random worlds dense enough for HPA* to miss the bound on some queries
+    void check_bound(double _epsilon, bool _diagonal, int _percent, bool _guarantee)
+    {
+        path_builder optimal;
+        path_builder hierarchical;
+        
+        random_world(optimal, { 128, 128 }, _diagonal, _percent, 5);
+        random_world(hierarchical, { 128, 128 }, _diagonal, _percent, 5);
+        hierarchical.set_search_mode(search_mode::HIERARCHICAL);
+        hierarchical.set_suboptimality(_epsilon);
+        hierarchical.set_hierarchical_guarantee(_guarantee);
+        
+        const double epsilon = _guarantee ? _epsilon : std::numeric_limits<double>::infinity();
+        const char* test = _guarantee ? "test_guaranteed_bound" : "test_reported_bound";
+        std::mt19937 random(17);
+        
+        for (int i = 0; i < 100; ++i)
+        {
+            const path_data data = random_query(random, { 128, 128 });
+            const vector2_array_i expected = optimal.find_path(data);
+            const vector2_array_i path = hierarchical.find_path(data);
+            
+            check_path(test, hierarchical, path, expected, epsilon);
+        }
+    }
+}
+
+void test_reported_bound()
+{
+    for (int percent : { 25, 35 })
+    {
+        check_bound(0.2, false, percent, false);
+        check_bound(0.2, true, percent, false);
+    }
+}
+
+void test_guaranteed_bound()
+{
+    for (double epsilon : epsilons)
+        for (int percent : { 25, 35 })
+        {
+            check_bound(epsilon, false, percent, true);
+            check_bound(epsilon, true, percent, true);
+        }
+}
+
+// Cache hits report the cost and bound of their own path, not of the last search
+void test_cached_paths()
+{
+    path_builder optimal;
+    path_builder hierarchical;
+    
+    random_world(optimal, { 128, 128 }, true, 30, 9);
+    random_world(hierarchical, { 128, 128 }, true, 30, 9);
+    hierarchical.set_search_mode(search_mode::HIERARCHICAL);
+    hierarchical.set_path_cache(64);
+    hierarchical.set_hierarchical_guarantee(true);
+    
+    std::mt19937 random(23);
+    std::uniform_int_distribution<int> coordinate(0, 127);
+    path_data queries[] = { random_query(random, { 128, 128 }), random_query(random, { 128, 128 }) };
+    
+    for (int i = 0; i < 200; ++i)
+    {
+        // A new pair now and then, with collision changes in between
+        if (i % 20 == 0)
+            queries[i / 20 % 2] = random_query(random, { 128, 128 });
+        
+        if (i % 7 == 0)
+        {
+            const vector2_i cell = { coordinate(random), coordinate(random) };
+            
+            if (i % 2 == 0)
+            {
+                optimal.add_collision(cell);
+                hierarchical.add_collision(cell);
+            }
+            else
+            {
+                optimal.remove_collision(cell);
+                hierarchical.remove_collision(cell);
+            }
+        }
+        
+        const path_data& data = queries[i % 2];
+        const vector2_array_i path = hierarchical.find_path(data);
+        
+        check_path("test_cached_paths", hierarchical, path, optimal.find_path(data), 0.2);
+    }
+    
+    if (hierarchical.get_path_cache().get_hits() == 0)
+        fail("test_cached_paths", "no query came from the cache");
+}
+
+// Paths of the old clusters are not served after a resize
+void test_cluster_size_change()
+{
+    path_builder cached;
+    random_world(cached, { 128, 128 }, true, 25, 13);
+    cached.set_search_mode(search_mode::HIERARCHICAL);
+    cached.set_path_cache(64);
+    
+    std::mt19937 random(29);
+    int changed = 0;
+    
+    for (int i = 0; i < 50; ++i)
+    {
+        path_builder resized;
+        random_world(resized, { 128, 128 }, true, 25, 13);
+        resized.set_search_mode(search_mode::HIERARCHICAL);
+        resized.set_cluster_size(8);
+        
+        const path_data data = random_query(random, { 128, 128 });
+        cached.set_cluster_size(16);
+        const vector2_array_i before = cached.find_path(data);
+        cached.set_cluster_size(8);
+        const vector2_array_i after = cached.find_path(data);
+        const vector2_array_i expected = resized.find_path(data);
+        
+        if (after != expected)
+            fail("test_cluster_size_change", "path differs from the new clusters");
+        
+        changed += (before != expected);
+    }
+    
+    if (changed == 0)
+        fail("test_cluster_size_change", "no path depends on the cluster size");
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_reported_bound", test_reported_bound);
+    run_test("test_guaranteed_bound", test_guaranteed_bound);
+    run_test("test_cached_paths", test_cached_paths);
+    run_test("test_cluster_size_change", test_cluster_size_change);
+    
+    return finish_suite();
+}
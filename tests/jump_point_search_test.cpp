@@ -0,0 +1,98 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "jump_point_search_test"
+#include "test_support.h"
+
+namespace
+{
+    void check_density(const char* _test, bool _diagonal, int _percent, unsigned _seed)
+    {
+        path_builder reference;
+        path_builder jump_point;
+        
+        random_world(reference, { 64, 64 }, _diagonal, _percent, _seed);
+        random_world(jump_point, { 64, 64 }, _diagonal, _percent, _seed);
+        reference_astar(reference);
+        jump_point.set_search_mode(search_mode::JUMP_POINT);
+        
+        compare_paths(_test, reference, jump_point, _diagonal, 100, _seed + 1);
+    }
+}
+
+// Jump points expand into the same optimal costs as A*, on open and cluttered worlds
+void test_optimal_paths()
+{
+    for (int percent : { 0, 10, 25, 40 })
+    {
+        check_density("test_optimal_paths", false, percent, 71 + percent);
+        check_density("test_optimal_paths", true, percent, 73 + percent);
+    }
+}
+
+// Collision changes between queries reach the jumps of the next query
+void test_collision_changes()
+{
+    path_builder reference;
+    path_builder jump_point;
+    
+    random_world(reference, { 64, 64 }, true, 20, 79);
+    random_world(jump_point, { 64, 64 }, true, 20, 79);
+    reference_astar(reference);
+    jump_point.set_search_mode(search_mode::JUMP_POINT);
+    
+    for (int round = 0; round < 5; ++round)
+    {
+        // A wall across most of the world, with its gap moving each round
+        for (int y = 0; y < 64; ++y)
+        {
+            const bool gap = (y / 8 == round);
+            
+            if (gap)
+            {
+                reference.remove_collision({ 32, y });
+                jump_point.remove_collision({ 32, y });
+            }
+            else
+            {
+                reference.add_collision({ 32, y });
+                jump_point.add_collision({ 32, y });
+            }
+        }
+        
+        compare_paths("test_collision_changes", reference, jump_point, true, 40, 83 + round);
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_optimal_paths", test_optimal_paths);
+    run_test("test_collision_changes", test_collision_changes);
+    
+    return finish_suite();
+}
@@ -0,0 +1,154 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <framework/landmark_heuristic.h>
+#include <framework/path_builder.h>
+#include <parallel/thread_pool.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "landmark_heuristic_test"
+#include "test_support.h"
+
+// ALT paths cost what the reference A* finds
+void test_optimal_paths()
+{
+    thread_pool pool(1);
+    
+    for (int percent : { 0, 15, 30, 40 })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            path_builder reference;
+            path_builder landmarks;
+            const unsigned seed = 211 + percent + diagonal;
+            
+            random_world(reference, { 64, 64 }, diagonal == 1, percent, seed);
+            random_world(landmarks, { 64, 64 }, diagonal == 1, percent, seed);
+            reference_astar(reference);
+            landmarks.set_search_backend(search_backend::CELL_ARRAYS);
+            landmarks.set_heuristic(landmarks.build_landmark_heuristic(8, pool, 2));
+            
+            compare_paths("test_optimal_paths", reference, landmarks, diagonal == 1, 100, seed + 1);
+        }
+    }
+}
+
+// Never above the cost of the optimal path, never below the distance it 
+// falls back to
+void test_admissible()
+{
+    thread_pool pool(0);
+    
+    for (int diagonal = 0; diagonal < 2; ++diagonal)
+    {
+        path_builder reference;
+        
+        random_world(reference, { 80, 50 }, diagonal == 1, 25, 5 + diagonal);
+        reference_astar(reference);
+        
+        const landmark_heuristic heuristic = reference.build_landmark_heuristic(6, pool, 1);
+        std::mt19937 random(6 + diagonal);
+        
+        for (int i = 0; i < 200; ++i)
+        {
+            const path_data data = random_query(random, { 80, 50 });
+            const vector2_array_i path = reference.find_path(data);
+            const int h = heuristic(data.start_coordinate, data.end_coordinate);
+            const int base = (diagonal == 1 
+                ? path_builder::octagonal(data.start_coordinate, data.end_coordinate) 
+                : path_builder::manhattan(data.start_coordinate, data.end_coordinate));
+            
+            if (!path.empty() && h > path_cost(path))
+                fail("test_admissible", "heuristic above the optimal cost");
+            
+            if (h < base)
+                fail("test_admissible", "heuristic below the distance on open ground");
+        }
+    }
+}
+
+// Tables built before collisions are added still give optimal paths
+void test_added_collisions()
+{
+    thread_pool pool(0);
+    path_builder reference;
+    path_builder landmarks;
+    
+    random_world(reference, { 64, 64 }, true, 15, 41);
+    random_world(landmarks, { 64, 64 }, true, 15, 41);
+    reference_astar(reference);
+    landmarks.set_search_backend(search_backend::CELL_ARRAYS);
+    landmarks.set_heuristic(landmarks.build_landmark_heuristic(8, pool, 1));
+    
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> coordinate(0, 63);
+    
+    for (int i = 0; i < 400; ++i)
+    {
+        const vector2_i cell = { coordinate(random), coordinate(random) };
+        reference.add_collision(cell);
+        landmarks.add_collision(cell);
+    }
+    
+    compare_paths("test_added_collisions", reference, landmarks, true, 100, 43);
+}
+
+// Tables built on several tasks match those of one
+void test_threaded_build()
+{
+    thread_pool pool(3);
+    path_builder builder;
+    
+    random_world(builder, { 70, 90 }, true, 20, 9);
+    
+    const landmark_heuristic single = builder.build_landmark_heuristic(12, pool, 1);
+    const landmark_heuristic threaded = builder.build_landmark_heuristic(12, pool, 4);
+    
+    if (single.get_landmarks() != threaded.get_landmarks())
+        fail("test_threaded_build", "landmarks differ");
+    
+    std::mt19937 random(10);
+    
+    for (int i = 0; i < 500; ++i)
+    {
+        const path_data data = random_query(random, { 70, 90 });
+        
+        if (single(data.start_coordinate, data.end_coordinate) != threaded(data.start_coordinate, data.end_coordinate))
+            fail("test_threaded_build", "heuristic values differ");
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_optimal_paths", test_optimal_paths);
+    run_test("test_admissible", test_admissible);
+    run_test("test_added_collisions", test_added_collisions);
+    run_test("test_threaded_build", test_threaded_build);
+    
+    return finish_suite();
+}
@@ -0,0 +1,136 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <framework/astar_search.h>
+#include <framework/memory_bounded_search.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "memory_bounded_search_test"
+#include "test_support.h"
+
+namespace
+{
+    // Walls all around _goal, which leaves it cut off from every other cell
+    void enclose(occupancy_grid& _walls, vector2_i _goal)
+    {
+        for (int y = -1; y <= 1; ++y)
+            for (int x = -1; x <= 1; ++x)
+                if (x != 0 || y != 0)
+                    _walls.set({ _goal.x + x, _goal.y + y });
+    }
+}
+
+void test_unreachable_goal()
+{
+    occupancy_grid walls;
+    walls.resize({ 6, 6 });
+    enclose(walls, { 3, 3 });
+    
+    memory_bounded_search search(walls);
+    
+    for (int directions = 4; directions <= 8; directions += 4)
+    {
+        const std::function<int(vector2_i, vector2_i)> heuristic = 
+            (directions == 8 ? path_builder::octagonal : path_builder::manhattan);
+        
+        if (!search.find_path({ 0, 0 }, { 3, 3 }, directions == 8, heuristic).empty())
+            fail("test_unreachable_goal", "path to an enclosed goal");
+    }
+    
+    // A wall across the whole world
+    walls.resize({ 20, 13 });
+    walls.clear();
+    
+    for (int y = 0; y < 13; ++y)
+        walls.set({ 9, y });
+    
+    if (!search.find_path({ 0, 0 }, { 19, 12 }, true, path_builder::octagonal).empty())
+        fail("test_unreachable_goal", "path through a wall");
+}
+
+void test_unreachable_goal_small_table()
+{
+    occupancy_grid walls;
+    walls.resize({ 20, 13 });
+    enclose(walls, { 15, 6 });
+    
+    memory_bounded_search search(walls);
+    search.set_node_limit(16);
+    
+    if (!search.find_path({ 0, 0 }, { 15, 6 }, false, path_builder::manhattan).empty())
+        fail("test_unreachable_goal_small_table", "path to an enclosed goal");
+}
+
+void test_optimal_paths()
+{
+    occupancy_grid walls;
+    walls.resize({ 64, 64 });
+    
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> coordinate(0, 63);
+    
+    for (int i = 0; i < 1000; ++i)
+        walls.set({ coordinate(random), coordinate(random) });
+    
+    memory_bounded_search search(walls);
+    astar_search astar(walls);
+    distance_table euclidean;
+    vector2_array_i expected;
+    
+    for (int i = 0; i < 100; ++i)
+    {
+        const vector2_i start = { coordinate(random), coordinate(random) };
+        const vector2_i goal = { coordinate(random), coordinate(random) };
+        const bool diagonal = (i % 2 == 1);
+        
+        if (walls.is_blocked(start) || walls.is_blocked(goal))
+            continue;
+        
+        const std::function<int(vector2_i, vector2_i)> heuristic = 
+            (diagonal ? path_builder::octagonal : path_builder::manhattan);
+        
+        astar.find_path(start, goal, diagonal, heuristic_type::CUSTOM, heuristic, euclidean, expected);
+        
+        const bool reachable = (!expected.empty() && expected.front() == static_cast<vector2_i>(goal));
+        const vector2_array_i path = search.find_path(start, goal, diagonal, heuristic);
+        
+        if (reachable != !path.empty())
+            fail("test_optimal_paths", "path found for only one of A* and IDA*");
+        else if (reachable && path_cost(path) != path_cost(expected))
+            fail("test_optimal_paths", "path cost differs from A*");
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_unreachable_goal", test_unreachable_goal);
+    run_test("test_unreachable_goal_small_table", test_unreachable_goal_small_table);
+    run_test("test_optimal_paths", test_optimal_paths);
+    
+    return finish_suite();
+}
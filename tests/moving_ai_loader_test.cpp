@@ -0,0 +1,158 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <framework/moving_ai_loader.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "moving_ai_loader_test"
+#include "test_support.h"
+
+namespace
+{
+    const char* const test_file = "moving_ai_loader_test.txt";
+    
+    void write_file(const char* _text)
+    {
+        std::ofstream(test_file) << _text;
+    }
+    
+    // Scenarios already read before the file under test
+    std::vector<scenario> earlier()
+    {
+        scenario entry;
+        entry.bucket = 7;
+        entry.start = { 1, 2 };
+        entry.goal = { 3, 4 };
+        entry.optimal_length = 2.5;
+        
+        return { entry };
+    }
+}
+
+void test_map_overflow()
+{
+    occupancy_grid walls;
+    
+    write_file("type octile\nheight 4294967298\nwidth 2\nmap\n..\n..\n");
+    
+    if (read_map_file(test_file, walls))
+        fail("test_map_overflow", "height past INT_MAX read");
+    
+    write_file("type octile\nheight 2\nwidth 2\nmap\n.@\n..\n");
+    
+    if (!read_map_file(test_file, walls) || walls.get_size().x != 2 || !walls.is_blocked({ 1, 0 }))
+        fail("test_map_overflow", "valid map not read");
+    
+    std::remove(test_file);
+}
+
+void test_scenario_overflow()
+{
+    std::vector<scenario> scenarios = earlier();
+    std::string map = "earlier.map";
+    
+    // The second query wraps around to a valid coordinate without the check
+    write_file(
+        "version 1\n"
+        "0\tarena.map\t49\t49\t1\t11\t1\t12\t1\n"
+        "0\tarena.map\t49\t49\t4294967297\t11\t1\t12\t1\n");
+    
+    if (read_scenario_file(test_file, scenarios, map))
+        fail("test_scenario_overflow", "coordinate past INT_MAX read");
+    
+    if (scenarios.size() != 1 || scenarios[0].bucket != 7 || map != "earlier.map")
+        fail("test_scenario_overflow", "failed read changed the output");
+    
+    write_file("version 1\n3\tarena.map\t49\t49\t-2147483648\t11\t1\t12\t1.5e1\n");
+    
+    if (!read_scenario_file(test_file, scenarios, map))
+        fail("test_scenario_overflow", "INT_MIN not read");
+    else if (scenarios.size() != 2 || scenarios[1].start.x != -2147483647 - 1 
+        || scenarios[1].optimal_length != 15.0 || map != "arena.map")
+        fail("test_scenario_overflow", "valid query not appended");
+    
+    std::remove(test_file);
+}
+
+void test_scenario_partial_file()
+{
+    std::vector<scenario> scenarios = earlier();
+    std::string map = "earlier.map";
+    
+    // Two good queries, then a truncated one
+    write_file(
+        "version 1\n"
+        "0\tarena.map\t49\t49\t1\t11\t1\t12\t1\n"
+        "0\tarena.map\t49\t49\t2\t11\t1\t12\t1\n"
+        "0\tarena.map\t49\t49\t3\t11\n");
+    
+    if (read_scenario_file(test_file, scenarios, map))
+        fail("test_scenario_partial_file", "truncated query read");
+    
+    if (scenarios.size() != 1 || map != "earlier.map")
+        fail("test_scenario_partial_file", "queries before the bad line kept");
+    
+    std::remove(test_file);
+}
+
+// Lines ending in CRLF read like the ones ending in LF
+void test_crlf_lines()
+{
+    occupancy_grid walls;
+    
+    write_file("type octile\r\nheight 2\r\nwidth 3\r\nmap\r\n.@.\r\nT..\r\n");
+    
+    if (!read_map_file(test_file, walls) || walls.get_size().x != 3 || walls.get_size().y != 2)
+        fail("test_crlf_lines", "CRLF map not read");
+    else if (!walls.is_blocked({ 1, 0 }) || !walls.is_blocked({ 0, 1 }) 
+        || walls.is_blocked({ 2, 0 }) || walls.is_blocked({ 2, 1 }))
+        fail("test_crlf_lines", "CRLF map cells differ");
+    
+    std::vector<scenario> scenarios;
+    std::string map;
+    
+    write_file("version 1\r\n0\tarena.map\t3\t2\t0\t0\t2\t1\t2.41421356\r\n");
+    
+    if (!read_scenario_file(test_file, scenarios, map))
+        fail("test_crlf_lines", "CRLF scenario not read");
+    else if (scenarios.size() != 1 || scenarios[0].goal.x != 2 || scenarios[0].goal.y != 1 || map != "arena.map")
+        fail("test_crlf_lines", "CRLF query differs");
+    
+    std::remove(test_file);
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_map_overflow", test_map_overflow);
+    run_test("test_scenario_overflow", test_scenario_overflow);
+    run_test("test_scenario_partial_file", test_scenario_partial_file);
+    run_test("test_crlf_lines", test_crlf_lines);
+    
+    return finish_suite();
+}
@@ -0,0 +1,93 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <framework/node_pool.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "node_pool_test"
+#include "test_support.h"
+
+// Released nodes are handed out again from the chunks already allocated
+void test_release_keeps_chunks()
+{
+    node_pool pool(256);
+    
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 1000; ++i)
+            pool.create({ i, round });
+        
+        if (pool.size() != 1000)
+            fail("test_release_keeps_chunks", "size is not the nodes created");
+        
+        if (pool.capacity() != 1024)
+            fail("test_release_keeps_chunks", "chunks allocated past the first round");
+        
+        std::size_t visited = 0;
+        bool current = true;
+        
+        pool.for_each([&](node* _node)
+        {
+            current = current && (_node->position.y == round);
+            ++visited;
+        });
+        
+        if (visited != 1000 || !current)
+            fail("test_release_keeps_chunks", "for_each visits other nodes than the live ones");
+        
+        pool.release();
+        
+        if (pool.size() != 0)
+            fail("test_release_keeps_chunks", "nodes left after release");
+    }
+}
+
+// Searches of the node graph draw every node from the pool, query after query
+void test_node_graph_paths()
+{
+    for (int diagonal = 0; diagonal < 2; ++diagonal)
+    {
+        path_builder reference;
+        path_builder pooled;
+        
+        random_world(reference, { 64, 64 }, diagonal == 1, 25, 31);
+        random_world(pooled, { 64, 64 }, diagonal == 1, 25, 31);
+        reference_astar(reference);
+        pooled.set_search_backend(search_backend::NODE_GRAPH);
+        pooled.set_open_list(open_list_type::BINARY_HEAP);
+        
+        compare_paths("test_node_graph_paths", reference, pooled, diagonal == 1, 200, 37);
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_release_keeps_chunks", test_release_keeps_chunks);
+    run_test("test_node_graph_paths", test_node_graph_paths);
+    
+    return finish_suite();
+}
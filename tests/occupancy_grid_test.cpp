@@ -0,0 +1,98 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <framework/occupancy_grid.h>
+#include <framework/tiled_grid.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "occupancy_grid_test"
+#include "test_support.h"
+
+namespace
+{
+    // Writes that change nothing must say so, callers invalidate on true
+    void check_changes(const char* _test, occupancy_grid& _walls)
+    {
+        if (!_walls.set({ 3, 4 }))
+            fail(_test, "set of a free cell reported no change");
+        
+        if (_walls.set({ 3, 4 }))
+            fail(_test, "set of a blocked cell reported a change");
+        
+        if (_walls.get_blocked_count() != 1)
+            fail(_test, "blocked count changed by a repeated set");
+        
+        if (!_walls.reset({ 3, 4 }))
+            fail(_test, "reset of a blocked cell reported no change");
+        
+        if (_walls.reset({ 3, 4 }))
+            fail(_test, "reset of a free cell reported a change");
+        
+        if (_walls.get_blocked_count() != 0)
+            fail(_test, "blocked count changed by a repeated reset");
+        
+        if (_walls.set({ -1, 4 }) || _walls.reset({ 3, 100000 }))
+            fail(_test, "write outside the world reported a change");
+    }
+}
+
+void test_bitmap_changes()
+{
+    occupancy_grid walls;
+    walls.resize({ 300, 300 });
+    check_changes("test_bitmap_changes", walls);
+}
+
+void test_tiled_changes()
+{
+    const char* tile_file = "occupancy_grid_test.tiles";
+    tiled_grid tiles;
+    
+    if (!tiled_grid::create(tile_file, { 512, 512 }, 256) || !tiles.open(tile_file, 2))
+    {
+        fail("test_tiled_changes", "tile file not created");
+        std::remove(tile_file);
+        return;
+    }
+    
+    occupancy_grid walls;
+    walls.attach(tiles);
+    check_changes("test_tiled_changes", walls);
+    
+    walls.detach();
+    tiles.close();
+    std::remove(tile_file);
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_bitmap_changes", test_bitmap_changes);
+    run_test("test_tiled_changes", test_tiled_changes);
+    
+    return finish_suite();
+}
@@ -0,0 +1,202 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <vector>
+#include <framework/path_builder.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "path_cache_test"
+#include "test_support.h"
+
+namespace
+{
+    bool reaches_goal(const vector2_array_i& _path, const path_data& _data)
+    {
+        return (!_path.empty() && _path.front() == static_cast<vector2_i>(_data.end_coordinate));
+    }
+}
+
+// Repeated queries come from the cache and match a fresh search
+void test_cached_paths()
+{
+    path_builder reference;
+    path_builder cached;
+    
+    random_world(reference, { 64, 64 }, true, 25, 61);
+    random_world(cached, { 64, 64 }, true, 25, 61);
+    reference_astar(reference);
+    cached.set_search_backend(search_backend::CELL_ARRAYS);
+    cached.set_path_cache(1000);
+    
+    std::mt19937 random(62);
+    std::vector<path_data> queries;
+    std::vector<vector2_array_i> first;
+    std::size_t partial = 0;
+    
+    for (int i = 0; i < 100; ++i)
+    {
+        queries.push_back(random_query(random, { 64, 64 }));
+        first.push_back(cached.find_path(queries.back()));
+        
+        // A partial path toward an unreachable goal is not cached
+        if (!first.back().empty() && !reaches_goal(first.back(), queries.back()))
+            ++partial;
+    }
+    
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        const vector2_array_i expected = reference.find_path(queries[i]);
+        const vector2_array_i path = cached.find_path(queries[i]);
+        
+        if (path != first[i])
+            fail("test_cached_paths", "repeated query returned another path");
+        
+        if (reaches_goal(expected, queries[i]) != reaches_goal(path, queries[i]) 
+            || (reaches_goal(path, queries[i]) && path_cost(path) != path_cost(expected)))
+            fail("test_cached_paths", "path differs from the reference A*");
+    }
+    
+    if (cached.get_path_cache().get_misses() > 100 + partial)
+        fail("test_cached_paths", "repeated queries missed the cache");
+}
+
+// Blocking a cell evicts the paths through it and keeps the others
+void test_added_collision()
+{
+    path_builder reference;
+    path_builder cached;
+    
+    clear_world(reference, { 32, 32 }, false);
+    clear_world(cached, { 32, 32 }, false);
+    reference_astar(reference);
+    cached.set_path_cache(100);
+    
+    const path_data crossing = query({ 2, 10 }, { 29, 10 });
+    const path_data elsewhere = query({ 2, 25 }, { 29, 25 });
+    const vector2_array_i first = cached.find_path(crossing);
+    cached.find_path(elsewhere);
+    
+    // Blocks a cell in the middle of the cached path
+    const vector2_i blocked = first[first.size() / 2];
+    reference.add_collision(blocked);
+    cached.add_collision(blocked);
+    
+    if (cached.get_path_cache().get_invalidations() != 1)
+        fail("test_added_collision", "blocking a cell did not evict exactly the path through it");
+    
+    const std::size_t hits = cached.get_path_cache().get_hits();
+    const vector2_array_i path = cached.find_path(crossing);
+    
+    if (cached.get_path_cache().get_hits() != hits)
+        fail("test_added_collision", "evicted path came from the cache");
+    
+    if (path_cost(path) != path_cost(reference.find_path(crossing)) || !is_connected_path(path, crossing, false))
+        fail("test_added_collision", "path differs from the reference A* after the change");
+    
+    for (const vector2_i& cell : path)
+        if (cell == blocked)
+            fail("test_added_collision", "path crosses the blocked cell");
+    
+    cached.find_path(elsewhere);
+    
+    if (cached.get_path_cache().get_hits() != hits + 1)
+        fail("test_added_collision", "path away from the blocked cell was searched again");
+}
+
+// Removing a collision can shorten any path, so none of the cached ones is used
+void test_removed_collision()
+{
+    path_builder reference;
+    path_builder cached;
+    
+    clear_world(reference, { 32, 32 }, false);
+    clear_world(cached, { 32, 32 }, false);
+    reference_astar(reference);
+    cached.set_path_cache(100);
+    
+    for (int y = 0; y < 30; ++y)
+    {
+        reference.add_collision({ 16, y });
+        cached.add_collision({ 16, y });
+    }
+    
+    const path_data data = query({ 2, 5 }, { 29, 5 });
+    
+    if (path_cost(cached.find_path(data)) != path_cost(reference.find_path(data)))
+        fail("test_removed_collision", "path differs from the reference A*");
+    
+    reference.remove_collision({ 16, 5 });
+    cached.remove_collision({ 16, 5 });
+    
+    const vector2_array_i path = cached.find_path(data);
+    
+    if (path_cost(path) != 270 || path_cost(path) != path_cost(reference.find_path(data)))
+        fail("test_removed_collision", "cached path kept the removed wall");
+}
+
+// The least recently used paths go first once the cache is full
+void test_capacity()
+{
+    path_builder cached;
+    
+    clear_world(cached, { 16, 16 }, true);
+    cached.set_path_cache(2);
+    
+    const path_data a = query({ 0, 0 }, { 15, 15 });
+    const path_data b = query({ 0, 15 }, { 15, 0 });
+    const path_data c = query({ 0, 8 }, { 15, 8 });
+    
+    cached.find_path(a);
+    cached.find_path(b);
+    cached.find_path(a);
+    cached.find_path(c);
+    
+    if (cached.get_path_cache().get_evictions() != 1 || cached.get_path_cache().get_size() != 2)
+        fail("test_capacity", "cache grew past its capacity");
+    
+    const std::size_t misses = cached.get_path_cache().get_misses();
+    cached.find_path(a);
+    
+    if (cached.get_path_cache().get_misses() != misses)
+        fail("test_capacity", "recently used path was evicted");
+    
+    cached.find_path(b);
+    
+    if (cached.get_path_cache().get_misses() != misses + 1)
+        fail("test_capacity", "least recently used path was kept");
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_cached_paths", test_cached_paths);
+    run_test("test_added_collision", test_added_collision);
+    run_test("test_removed_collision", test_removed_collision);
+    run_test("test_capacity", test_capacity);
+    
+    return finish_suite();
+}
@@ -0,0 +1,188 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <framework/moving_ai_loader.h>
+#include <framework/path_builder.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "scenario_test"
+#include "test_support.h"
+
+namespace
+{
+    const char* const map_file = "scenario_test.map";
+    const char* const scenario_file = "scenario_test.map.scen";
+    
+    // Walled rooms with one opening each, a box of trees and open borders
+    const char* const map_text = 
+        "type octile\n"
+        "height 10\n"
+        "width 20\n"
+        "map\n"
+        "....................\n"
+        "..@@@@@@@@@@@@..T...\n"
+        "..@..........@......\n"
+        "..@..TTTT....@..@@@.\n"
+        "..@..T..T....@..@...\n"
+        "..@..T..T....@..@.@@\n"
+        "..@.....T.......@...\n"
+        "..@@@@@@@@@@@@@@@@..\n"
+        "....................\n"
+        "T..................T\n";
+    
+    // MovingAI octile lengths, which never cut a corner
+    const char* const scenario_text = 
+        "version 1\n"
+        "0\tscenario_test.map\t20\t10\t0\t0\t19\t8\t26.41421356\n"
+        "0\tscenario_test.map\t20\t10\t4\t4\t10\t2\t8.00000000\n"
+        "0\tscenario_test.map\t20\t10\t6\t4\t19\t4\t30.65685425\n"
+        "0\tscenario_test.map\t20\t10\t1\t9\t18\t9\t17.00000000\n"
+        "1\tscenario_test.map\t20\t10\t3\t2\t15\t6\t14.24264069\n"
+        "1\tscenario_test.map\t20\t10\t7\t4\t7\t5\t1.00000000\n"
+        "1\tscenario_test.map\t20\t10\t19\t6\t0\t8\t20.41421356\n"
+        "1\tscenario_test.map\t20\t10\t12\t5\t17\t4\t15.41421356\n"
+        "2\tscenario_test.map\t20\t10\t10\t0\t10\t8\t26.00000000\n"
+        "2\tscenario_test.map\t20\t10\t5\t2\t5\t2\t0.00000000\n";
+    
+    // Costs of the queries above in the 10/14 units of the searches, 
+    // 4-connected, then 8-connected with diagonals past blocked corners
+    const int costs[][2] = 
+    {
+        { 270, 258 }, { 80, 74 }, { 330, 264 }, { 170, 170 }, { 160, 136 }, 
+        { 10, 10 }, { 210, 198 }, { 160, 124 }, { 260, 238 }, { 0, 0 }
+    };
+    
+    // The modes that return optimal paths
+    const search_mode modes[] = 
+    {
+        search_mode::ASTAR, search_mode::JUMP_POINT, search_mode::BIDIRECTIONAL, 
+        search_mode::INCREMENTAL, search_mode::FLOW_FIELD, search_mode::CONTRACTION, 
+        search_mode::MEMORY_BOUNDED, search_mode::FRINGE
+    };
+    
+    bool read_files(std::vector<scenario>& _scenarios, path_builder& _builder)
+    {
+        std::ofstream(map_file) << map_text;
+        std::ofstream(scenario_file) << scenario_text;
+        
+        std::string map;
+        
+        return read_scenario_file(scenario_file, _scenarios, map) 
+            && map == map_file 
+            && _builder.load_map(map_file);
+    }
+    
+    void remove_files()
+    {
+        std::remove(map_file);
+        std::remove(scenario_file);
+    }
+}
+
+// The scenario reads back as written
+void test_read_scenario()
+{
+    std::vector<scenario> scenarios;
+    path_builder builder;
+    
+    if (!read_files(scenarios, builder))
+    {
+        fail("test_read_scenario", "map or scenario file not read");
+        remove_files();
+        return;
+    }
+    
+    if (scenarios.size() != sizeof(costs) / sizeof(costs[0]))
+        fail("test_read_scenario", "wrong number of queries");
+    else if (scenarios[2].bucket != 0 || scenarios[2].start.x != 6 || scenarios[2].start.y != 4 
+        || scenarios[2].goal.x != 19 || scenarios[2].goal.y != 4 
+        || std::fabs(scenarios[2].optimal_length - 30.65685425) > 1e-9)
+        fail("test_read_scenario", "query read wrong");
+    
+    if (builder.get_world_size().x != 20 || builder.get_world_size().y != 10)
+        fail("test_read_scenario", "map size read wrong");
+    
+    remove_files();
+}
+
+// Every optimal mode finds the fixed cost of every query, with either 
+// movement and backend
+void test_scenario_costs()
+{
+    std::vector<scenario> scenarios;
+    path_builder builder;
+    
+    if (!read_files(scenarios, builder))
+    {
+        fail("test_scenario_costs", "map or scenario file not read");
+        remove_files();
+        return;
+    }
+    
+    remove_files();
+    
+    for (int diagonal = 0; diagonal < 2; ++diagonal)
+    {
+        builder.set_diagonal_movement(diagonal == 1);
+        builder.set_heuristic(diagonal == 1 ? path_builder::octagonal : path_builder::manhattan);
+        
+        for (search_backend backend : { search_backend::NODE_GRAPH, search_backend::CELL_ARRAYS })
+        {
+            builder.set_search_backend(backend);
+            
+            for (search_mode mode : modes)
+            {
+                builder.set_search_mode(mode);
+                
+                if (mode == search_mode::CONTRACTION)
+                    builder.build_contraction_hierarchy();
+                
+                for (std::size_t i = 0; i < scenarios.size() && i < sizeof(costs) / sizeof(costs[0]); ++i)
+                {
+                    const path_data data = query(scenarios[i].start, scenarios[i].goal);
+                    const vector2_array_i path = builder.find_path(data);
+                    
+                    if (!is_connected_path(path, data, diagonal == 1))
+                        fail("test_scenario_costs", "path does not join start and goal cell by cell");
+                    else if (path_cost(path) != costs[i][diagonal])
+                        fail("test_scenario_costs", "path cost differs from the scenario");
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_read_scenario", test_read_scenario);
+    run_test("test_scenario_costs", test_scenario_costs);
+    
+    return finish_suite();
+}
@@ -0,0 +1,122 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <random>
+#include <framework/search_grid.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "search_grid_test"
+#include "test_support.h"
+
+// A new generation forgets every cell without touching the arrays
+void test_reset_forgets_cells()
+{
+    search_grid grid;
+    grid.resize(100);
+    
+    for (uint32_t id = 0; id < 100; id += 3)
+    {
+        grid.open(id, static_cast<int32_t>(id) * 10, 5);
+        
+        if (id % 2 == 0)
+            grid.close(id);
+    }
+    
+    if (grid.get_state(3) != node_state::IN_OPEN_LIST || grid.get_state(6) != node_state::IN_CLOSED_LIST)
+        fail("test_reset_forgets_cells", "state of an opened cell lost");
+    
+    if (grid.get_g(9) != 90 || grid.get_parent(9) != 5 || grid.get_state(1) != node_state::NONE)
+        fail("test_reset_forgets_cells", "cost, parent or untouched state wrong");
+    
+    grid.reset();
+    
+    for (uint32_t id = 0; id < 100; ++id)
+        if (grid.get_state(id) != node_state::NONE)
+            fail("test_reset_forgets_cells", "cell kept its state after reset");
+    
+    grid.open(7, 70, search_grid::no_parent);
+    grid.resize(100);
+    
+    if (grid.get_state(7) != node_state::IN_OPEN_LIST)
+        fail("test_reset_forgets_cells", "resize to the same size dropped the cells");
+    
+    grid.resize(50);
+    
+    if (grid.get_state(7) != node_state::NONE)
+        fail("test_reset_forgets_cells", "resize kept the cells of the old size");
+}
+
+// Queries reuse the arrays through collision changes and resizes
+void test_cell_array_paths()
+{
+    for (int diagonal = 0; diagonal < 2; ++diagonal)
+    {
+        path_builder reference;
+        path_builder cells;
+        
+        random_world(reference, { 64, 64 }, diagonal == 1, 25, 41);
+        random_world(cells, { 64, 64 }, diagonal == 1, 25, 41);
+        reference_astar(reference);
+        cells.set_search_backend(search_backend::CELL_ARRAYS);
+        
+        compare_paths("test_cell_array_paths", reference, cells, diagonal == 1, 100, 43);
+        
+        std::mt19937 random(47);
+        std::uniform_int_distribution<int> coordinate(0, 63);
+        
+        for (int i = 0; i < 200; ++i)
+        {
+            const vector2_i cell = { coordinate(random), coordinate(random) };
+            
+            if (i % 2 == 0)
+            {
+                reference.add_collision(cell);
+                cells.add_collision(cell);
+            }
+            else
+            {
+                reference.remove_collision(cell);
+                cells.remove_collision(cell);
+            }
+        }
+        
+        compare_paths("test_cell_array_paths", reference, cells, diagonal == 1, 100, 53);
+        
+        random_world(reference, { 48, 80 }, diagonal == 1, 30, 59);
+        random_world(cells, { 48, 80 }, diagonal == 1, 30, 59);
+        
+        compare_paths("test_cell_array_paths", reference, cells, diagonal == 1, 100, 61);
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_reset_forgets_cells", test_reset_forgets_cells);
+    run_test("test_cell_array_paths", test_cell_array_paths);
+    
+    return finish_suite();
+}
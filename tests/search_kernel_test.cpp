@@ -0,0 +1,223 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <functional>
+#include <random>
+#include <framework/distance_table.h>
+#include <framework/indexed_heap.h>
+#include <framework/occupancy_grid.h>
+#include <framework/path_builder.h>
+#include <framework/search_grid.h>
+#include <framework/search_kernel.h>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "search_kernel_test"
+#include "test_support.h"
+
+namespace
+{
+    // Scores of score_neighbors, vectorized where SSE2 is on, against the 
+    // heuristic of path_builder called once per neighbor
+    template<class neighborhood, class heuristic_policy>
+    bool same_scores(
+          const heuristic_policy& _policy
+        , int (*_heuristic)(vector2_i, vector2_i)
+        , int _x
+        , int _y
+        , vector2_i _goal)
+    {
+        alignas(16) int32_t h[8];
+        score_neighbors<neighborhood>(_policy, _x, _y, _goal, h);
+        
+        for (int i = 0; i < neighborhood::count; ++i)
+            if (h[i] != _heuristic({ _x + grid_direction_x[i], _y + grid_direction_y[i] }, _goal))
+                return false;
+        
+        return true;
+    }
+    
+    void random_walls(occupancy_grid& _walls, vector2_i _size, int _percent, unsigned _seed)
+    {
+        _walls.resize(_size);
+        
+        std::mt19937 random(_seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        
+        for (int y = 0; y < _size.y; ++y)
+            for (int x = 0; x < _size.x; ++x)
+                if (percent(random) < _percent)
+                    _walls.set({ x, y });
+    }
+}
+
+void test_neighbor_scores()
+{
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> far(-5000, 5000);
+    std::uniform_int_distribution<int> near(0, 1023);
+    
+    distance_table table;
+    table.resize({ 1024, 1024 });
+    
+    for (int i = 0; i < 100000; ++i)
+    {
+        const int x = far(random);
+        const int y = far(random);
+        const vector2_i goal = { far(random), far(random) };
+        
+        if (!same_scores<four_neighbors>(manhattan_policy(), path_builder::manhattan, x, y, goal)
+            || !same_scores<eight_neighbors>(manhattan_policy(), path_builder::manhattan, x, y, goal))
+            fail("test_neighbor_scores", "manhattan scores differ");
+        
+        if (!same_scores<four_neighbors>(octagonal_policy(), path_builder::octagonal, x, y, goal)
+            || !same_scores<eight_neighbors>(octagonal_policy(), path_builder::octagonal, x, y, goal))
+            fail("test_neighbor_scores", "octagonal scores differ");
+        
+        // Neighbors of cells inside the world stay within the table
+        const int inner_x = 1 + near(random) % 1022;
+        const int inner_y = 1 + near(random) % 1022;
+        const vector2_i inner_goal = { near(random), near(random) };
+        
+        if (!same_scores<eight_neighbors>(euclidean_table_policy{ table }, path_builder::euclidean, inner_x, inner_y, inner_goal))
+            fail("test_neighbor_scores", "euclidean table scores differ");
+    }
+}
+
+void test_blocked_neighbors()
+{
+    // A width off multiples of 64 puts row triples across words of the bitmap
+    occupancy_grid walls;
+    random_walls(walls, { 203, 77 }, 40, 5);
+    
+    for (int y = -1; y <= 77; ++y)
+    {
+        for (int x = -1; x <= 203; ++x)
+        {
+            const uint32_t blocked = blocked_neighbors(walls, x, y);
+            
+            for (int i = 0; i < 8; ++i)
+            {
+                if (((blocked >> i) & 1) != static_cast<uint32_t>(walls.is_blocked(x + grid_direction_x[i], y + grid_direction_y[i])))
+                    fail("test_blocked_neighbors", "blocked mask differs from the cells");
+            }
+        }
+    }
+}
+
+void test_kernel_paths()
+{
+    occupancy_grid walls;
+    random_walls(walls, { 150, 97 }, 25, 8);
+    
+    distance_table table;
+    table.resize(walls.get_size());
+    
+    const std::function<int(vector2_i, vector2_i)> heuristics[] = 
+        { path_builder::manhattan, path_builder::octagonal, path_builder::euclidean };
+    const heuristic_type types[] = 
+        { heuristic_type::MANHATTAN, heuristic_type::OCTAGONAL, heuristic_type::EUCLIDEAN };
+    
+    search_grid cells;
+    indexed_heap<double, 2> open;
+    vector2_array_i kernel_path;
+    vector2_array_i scalar_path;
+    
+    std::mt19937 random(13);
+    std::uniform_int_distribution<int> x(0, 149);
+    std::uniform_int_distribution<int> y(0, 96);
+    
+    for (int query = 0; query < 60; ++query)
+    {
+        const vector2_i start = { x(random), y(random) };
+        const vector2_i goal = { x(random), y(random) };
+        
+        for (int kind = 0; kind < 3; ++kind)
+        {
+            for (int diagonal = 0; diagonal < 2; ++diagonal)
+            {
+                // The same heuristic through the function expands the same cells
+                const std::size_t kernel_expansions = search_cells(walls, cells, open, start, goal, 
+                    diagonal != 0, types[kind], heuristics[kind], table, kernel_path);
+                const std::size_t scalar_expansions = search_cells(walls, cells, open, start, goal, 
+                    diagonal != 0, heuristic_type::CUSTOM, heuristics[kind], table, scalar_path);
+                
+                if (kernel_path != scalar_path)
+                    fail("test_kernel_paths", "paths differ");
+                
+                if (kernel_expansions != scalar_expansions)
+                    fail("test_kernel_paths", "expansions differ");
+            }
+        }
+    }
+}
+
+// A heuristic path_builder does not know runs through its std::function, 
+// and finds the paths the kernel of the same built-in heuristic finds
+void test_custom_heuristic_paths()
+{
+    typedef int (*heuristic_function)(vector2_i, vector2_i);
+    
+    for (heuristic_function builtin : { path_builder::manhattan, path_builder::octagonal, path_builder::euclidean })
+    {
+        for (int diagonal = 0; diagonal < 2; ++diagonal)
+        {
+            path_builder kernel;
+            path_builder custom;
+            const unsigned seed = 17 + diagonal;
+            
+            random_world(kernel, { 90, 70 }, diagonal == 1, 25, seed);
+            random_world(custom, { 90, 70 }, diagonal == 1, 25, seed);
+            kernel.set_search_backend(search_backend::CELL_ARRAYS);
+            custom.set_search_backend(search_backend::CELL_ARRAYS);
+            kernel.set_heuristic(builtin);
+            custom.set_heuristic([builtin](vector2_i _a, vector2_i _b) { return builtin(_a, _b); });
+            
+            std::mt19937 random(seed);
+            
+            for (int query = 0; query < 40; ++query)
+            {
+                const path_data data = random_query(random, { 90, 70 });
+                
+                if (kernel.find_path(data) != custom.find_path(data))
+                    fail("test_custom_heuristic_paths", "paths differ");
+                
+                if (kernel.get_expansions() != custom.get_expansions())
+                    fail("test_custom_heuristic_paths", "expansions differ");
+            }
+        }
+    }
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_neighbor_scores", test_neighbor_scores);
+    run_test("test_blocked_neighbors", test_blocked_neighbors);
+    run_test("test_kernel_paths", test_kernel_paths);
+    run_test("test_custom_heuristic_paths", test_custom_heuristic_paths);
+    
+    return finish_suite();
+}
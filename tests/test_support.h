@@ -0,0 +1,189 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <framework/path_builder.h>
+
+/*
+ * Helpers of the suites in tests/, which print the results in the format 
+ * of the NetBeans Simple C++ Test Suite.  A suite defines TEST_SUITE to its 
+ * name before it includes this header.
+ */
+
+#ifndef TEST_SUITE
+#error "define TEST_SUITE to the name of the suite before including test_support.h"
+#endif
+
+inline void fail(const char* _test, const char* _message)
+{
+    std::cout << "%TEST_FAILED% time=0 testname=" << _test 
+        << " (" TEST_SUITE ") message=" << _message << std::endl;
+}
+
+inline void start_suite()
+{
+    std::cout << "%SUITE_STARTING% " TEST_SUITE << std::endl;
+    std::cout << "%SUITE_STARTED%" << std::endl;
+}
+
+// Runs _function between the start and finish lines of the test _test
+inline void run_test(const char* _test, void (*_function)())
+{
+    std::cout << "%TEST_STARTED% " << _test << " (" TEST_SUITE ")" << std::endl;
+    _function();
+    std::cout << "%TEST_FINISHED% time=0 " << _test << " (" TEST_SUITE ")" << std::endl;
+}
+
+inline int finish_suite()
+{
+    std::cout << "%SUITE_FINISHED% time=0" << std::endl;
+    
+    return (EXIT_SUCCESS);
+}
+
+// Cost of a path of cells in the 10/14 units of the searches
+inline int path_cost(const vector2_array_i& _path)
+{
+    int cost = 0;
+    
+    for (std::size_t i = 1; i < _path.size(); ++i)
+        cost += (_path[i].x != _path[i - 1].x && _path[i].y != _path[i - 1].y ? 14 : 10);
+    
+    return cost;
+}
+
+inline path_data query(vector2_i _start, vector2_i _goal)
+{
+    path_data data;
+    data.start_coordinate = _start;
+    data.end_coordinate = _goal;
+    
+    return data;
+}
+
+// Start and goal anywhere in a world of _size cells
+inline path_data random_query(std::mt19937& _random, vector2_i _size)
+{
+    std::uniform_int_distribution<int> x(0, _size.x - 1);
+    std::uniform_int_distribution<int> y(0, _size.y - 1);
+    const vector2_i start = { x(_random), y(_random) };
+    
+    return query(start, { x(_random), y(_random) });
+}
+
+// Free world of _size cells, without the random obstacles of the 
+// constructor, searched with the heuristic that is exact on open ground
+inline void clear_world(path_builder& _builder, vector2_i _size, bool _diagonal)
+{
+    for (int y = 0; y < 25; ++y)
+        for (int x = 0; x < 25; ++x)
+            _builder.remove_collision({ x, y });
+    
+    _builder.set_world_size(_size);
+    _builder.set_diagonal_movement(_diagonal);
+    _builder.set_heuristic(_diagonal ? path_builder::octagonal : path_builder::manhattan);
+}
+
+// clear_world, then every cell blocked with a chance of _percent in 100
+inline void random_world(path_builder& _builder, vector2_i _size, bool _diagonal, int _percent, unsigned _seed)
+{
+    clear_world(_builder, _size, _diagonal);
+    
+    std::mt19937 random(_seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    
+    for (int y = 0; y < _size.y; ++y)
+        for (int x = 0; x < _size.x; ++x)
+            if (percent(random) < _percent)
+                _builder.add_collision({ x, y });
+}
+
+// The original A* of path_builder, on the node graph with a linear scan, 
+// which the other searches are checked against
+inline void reference_astar(path_builder& _builder)
+{
+    _builder.set_search_backend(search_backend::NODE_GRAPH);
+    _builder.set_open_list(open_list_type::LINEAR_SCAN);
+}
+
+// Whether _path joins the ends of _data with one step between neighbors, 
+// diagonal ones only with _diagonal
+inline bool is_connected_path(const vector2_array_i& _path, const path_data& _data, bool _diagonal)
+{
+    if (_path.empty())
+        return false;
+    
+    const bool forward = (_path.front() == static_cast<vector2_i>(_data.start_coordinate) 
+        && _path.back() == static_cast<vector2_i>(_data.end_coordinate));
+    const bool backward = (_path.front() == static_cast<vector2_i>(_data.end_coordinate) 
+        && _path.back() == static_cast<vector2_i>(_data.start_coordinate));
+    
+    if (!forward && !backward)
+        return false;
+    
+    for (std::size_t i = 1; i < _path.size(); ++i)
+    {
+        const int dx = std::abs(_path[i].x - _path[i - 1].x);
+        const int dy = std::abs(_path[i].y - _path[i - 1].y);
+        
+        if (dx > 1 || dy > 1 || dx + dy == 0 || (!_diagonal && dx + dy == 2))
+            return false;
+    }
+    
+    return true;
+}
+
+// Runs _count random queries on _reference and _builder, which hold the 
+// same world, and fails _test where _builder finds no path, another cost 
+// or a path of cells that are not neighbors
+inline void compare_paths(
+      const char* _test
+    , path_builder& _reference
+    , path_builder& _builder
+    , bool _diagonal
+    , int _count
+    , unsigned _seed)
+{
+    std::mt19937 random(_seed);
+    
+    for (int i = 0; i < _count; ++i)
+    {
+        const path_data data = random_query(random, _reference.get_world_size());
+        const vector2_array_i expected = _reference.find_path(data);
+        const vector2_array_i path = _builder.find_path(data);
+        
+        if (expected.empty() != path.empty())
+            fail(_test, "reachability differs from the reference A*");
+        else if (path_cost(path) != path_cost(expected))
+            fail(_test, "path cost differs from the reference A*");
+        else if (!path.empty() && !is_connected_path(path, data, _diagonal))
+            fail(_test, "path does not join start and goal cell by cell");
+    }
+}
+
+#endif /* TEST_SUPPORT_H */
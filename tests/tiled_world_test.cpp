@@ -0,0 +1,209 @@
+/* 
+ * MIT License
+ * Copyright (c) 2018 Robert Slattery
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <random>
+
+/*
+ * Simple C++ Test Suite
+ */
+
+#define TEST_SUITE "tiled_world_test"
+#include "test_support.h"
+
+namespace
+{
+    const char* const tile_file = "tiled_world_test.tiles";
+    
+    const search_mode modes[] = 
+    {
+        search_mode::ASTAR, search_mode::JUMP_POINT, search_mode::HIERARCHICAL, 
+        search_mode::BIDIRECTIONAL, search_mode::INCREMENTAL, search_mode::ANYTIME, 
+        search_mode::FLOW_FIELD, search_mode::CONTRACTION, search_mode::ANY_ANGLE, 
+        search_mode::LAZY_ANY_ANGLE, search_mode::WEIGHTED, search_mode::FOCAL, 
+        search_mode::MEMORY_BOUNDED, search_mode::FRINGE
+    };
+    
+    // Walls around the square of cells from _corner to _corner + _size - 1
+    void enclose(path_builder& _builder, vector2_i _corner, int _size)
+    {
+        for (int i = -1; i <= _size; ++i)
+        {
+            _builder.add_collision({ _corner.x + i, _corner.y - 1 });
+            _builder.add_collision({ _corner.x + i, _corner.y + _size });
+            _builder.add_collision({ _corner.x - 1, _corner.y + i });
+            _builder.add_collision({ _corner.x + _size, _corner.y + i });
+        }
+    }
+}
+
+void test_every_mode_on_tiles()
+{
+    path_builder memory;
+    path_builder tiled;
+    
+    if (!tiled_grid::create(tile_file, { 512, 512 }, 256) || !tiled.open_world(tile_file, 2))
+    {
+        fail("test_every_mode_on_tiles", "tile file did not open");
+        return;
+    }
+    
+    clear_world(memory, { 512, 512 }, true);
+    tiled.set_diagonal_movement(true);
+    tiled.set_heuristic(path_builder::octagonal);
+    
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> coordinate(0, 511);
+    std::uniform_int_distribution<int> offset(-30, 30);
+    
+    for (int i = 0; i < 50000; ++i)
+    {
+        const vector2_i cell = { coordinate(random), coordinate(random) };
+        memory.add_collision(cell);
+        tiled.add_collision(cell);
+    }
+    
+    // Across the corners of the tiles
+    for (int i = 0; i < 20; ++i)
+    {
+        const vector2_i start = { 256 + offset(random), 256 + offset(random) };
+        const path_data data = query(start, { start.x + offset(random), start.y + offset(random) });
+        const vector2_array_i expected = memory.find_path(data);
+        
+        for (search_mode mode : modes)
+        {
+            tiled.set_search_mode(mode);
+            
+            if (tiled.get_active_mode() != search_mode::MEMORY_BOUNDED)
+                fail("test_every_mode_on_tiles", "tiles searched without the memory-bounded mode");
+            
+            const vector2_array_i path = tiled.find_path(data);
+            
+            if (expected.empty() != path.empty() || path_cost(path) != path_cost(expected))
+                fail("test_every_mode_on_tiles", "path differs from A* in memory");
+        }
+    }
+    
+    tiled.close_world();
+    std::remove(tile_file);
+}
+
+void test_unreachable_goal_on_tiles()
+{
+    path_builder builder;
+    
+    if (!tiled_grid::create(tile_file, { 512, 512 }, 256) || !builder.open_world(tile_file, 2))
+    {
+        fail("test_unreachable_goal_on_tiles", "tile file did not open");
+        return;
+    }
+    
+    // A room small enough for the table to search all of it
+    enclose(builder, { 250, 250 }, 12);
+    
+    for (search_mode mode : modes)
+    {
+        builder.set_search_mode(mode);
+        
+        if (!builder.find_path(query({ 255, 255 }, { 400, 400 })).empty())
+            fail("test_unreachable_goal_on_tiles", "path out of a closed room");
+    }
+    
+    builder.close_world();
+    std::remove(tile_file);
+}
+
+// Walled-in ends are found by the reachability check long before the 
+// expansion limit
+void test_enclosed_ends_on_large_tiles()
+{
+    path_builder builder;
+    
+    if (!tiled_grid::create(tile_file, { 100000, 100000 }, 256) || !builder.open_world(tile_file, 16))
+    {
+        fail("test_enclosed_ends_on_large_tiles", "tile file did not open");
+        return;
+    }
+    
+    builder.set_diagonal_movement(true);
+    builder.set_heuristic(path_builder::octagonal);
+    enclose(builder, { 60000, 60000 }, 3);
+    
+    const path_data queries[] = { query({ 10, 10 }, { 60001, 60001 }), query({ 60001, 60001 }, { 10, 10 }) };
+    
+    for (const path_data& data : queries)
+        for (search_mode mode : modes)
+        {
+            builder.set_search_mode(mode);
+            
+            if (!builder.find_path(data).empty())
+                fail("test_enclosed_ends_on_large_tiles", "path out of a closed box");
+            
+            if (builder.get_expansions() > 65536)
+                fail("test_enclosed_ends_on_large_tiles", "enclosed end searched past the probe");
+        }
+    
+    // Inside the box the fills meet
+    if (builder.find_path(query({ 60000, 60000 }, { 60002, 60002 })).size() != 3)
+        fail("test_enclosed_ends_on_large_tiles", "no path inside the box");
+    
+    builder.close_world();
+    std::remove(tile_file);
+}
+
+void test_expansion_limit()
+{
+    path_builder builder;
+    
+    if (!tiled_grid::create(tile_file, { 4096, 4096 }, 256) || !builder.open_world(tile_file, 16))
+    {
+        fail("test_expansion_limit", "tile file did not open");
+        return;
+    }
+    
+    // Too many cells around the start for the table to prove the goal 
+    // unreachable, and no enclosure check to catch the goal first
+    builder.set_reachability_check(false);
+    builder.set_expansion_limit(100000);
+    enclose(builder, { 3000, 3000 }, 1);
+    
+    if (!builder.find_path(query({ 1, 1 }, { 3000, 3000 })).empty())
+        fail("test_expansion_limit", "path to an enclosed goal");
+    
+    if (builder.get_expansions() != 100000)
+        fail("test_expansion_limit", "search did not stop at the limit");
+    
+    builder.close_world();
+    std::remove(tile_file);
+}
+
+int main()
+{
+    start_suite();
+    run_test("test_every_mode_on_tiles", test_every_mode_on_tiles);
+    run_test("test_unreachable_goal_on_tiles", test_unreachable_goal_on_tiles);
+    run_test("test_enclosed_ends_on_large_tiles", test_enclosed_ends_on_large_tiles);
+    run_test("test_expansion_limit", test_expansion_limit);
+    
+    return finish_suite();
+}